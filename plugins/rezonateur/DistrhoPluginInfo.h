@@ -21,6 +21,7 @@
 #define DISTRHO_PLUGIN_WANT_STATE      0
 #define DISTRHO_PLUGIN_WANT_FULL_STATE 0
 #define DISTRHO_PLUGIN_NUM_PROGRAMS    0
+#define DISTRHO_PLUGIN_WANT_LATENCY    1
 
 // for level monitoring
 #define DISTRHO_PLUGIN_WANT_DIRECT_ACCESS 1
@@ -5,21 +5,22 @@
 constexpr unsigned RezonateurPlugin::NumChannels;
 
 RezonateurPlugin::RezonateurPlugin()
-    : Plugin(Parameter_Count, DISTRHO_PLUGIN_NUM_PROGRAMS, State_Count),
-      fCurrentOutputLevel{}
+    : Plugin(Parameter_Count, DISTRHO_PLUGIN_NUM_PROGRAMS, State_Count)
 {
     double samplerate = getSampleRate();
 
-    for (unsigned c = 0; c < NumChannels; ++c) {
-        fOutputLevelFollower[c].release(0.5 * samplerate);
-        fRez[c].init(samplerate);
-    }
+    for (unsigned c = 0; c < NumChannels; ++c)
+        fOutputMeter[c].init(samplerate);
+    fRez.init(samplerate, NumChannels);
+    setBufferSize(getBufferSize());
 
     for (unsigned p = 0; p < Parameter_Count; ++p) {
         Parameter param;
         InitParameter(p, param);
         setParameterValue(p, param.ranges.def);
     }
+    // the defaults apply at once, without smoothing
+    fRez.updateCoefficients();
 }
 
 RezonateurPlugin::~RezonateurPlugin()
@@ -72,33 +73,39 @@ float RezonateurPlugin::getParameterValue(uint32_t index) const
     case pIdBypass:
         return fBypassed;
     case pIdMode:
-        return fRez[0].getFilterMode();
+        return fRez.getFilterMode();
     case pIdOversampling:
-        return fRez[0].getOversampling();
+        return fRez.getOversampling();
     case pIdGain1:
-        return fRez[0].getFilterGain(0);
+        return fRez.getFilterGain(0);
     case pIdCutoff1:
-        return fRez[0].getFilterCutoff(0);
+        return fRez.getFilterCutoff(0);
     case pIdEmph1:
-        return fRez[0].getFilterEmph(0);
+        return fRez.getFilterEmph(0);
     case pIdGain2:
-        return fRez[0].getFilterGain(1);
+        return fRez.getFilterGain(1);
     case pIdCutoff2:
-        return fRez[0].getFilterCutoff(1);
+        return fRez.getFilterCutoff(1);
     case pIdEmph2:
-        return fRez[0].getFilterEmph(1);
+        return fRez.getFilterEmph(1);
     case pIdGain3:
-        return fRez[0].getFilterGain(2);
+        return fRez.getFilterGain(2);
     case pIdCutoff3:
-        return fRez[0].getFilterCutoff(2);
+        return fRez.getFilterCutoff(2);
     case pIdEmph3:
-        return fRez[0].getFilterEmph(2);
+        return fRez.getFilterEmph(2);
     case pIdPreGain:
-        return fPreGain;
+        return fRez.getInputGain();
     case pIdDryGain:
         return fDryGain;
     case pIdWetGain:
         return fWetGain;
+    case pIdOversamplerType:
+        return fRez.getOversamplerType();
+    case pIdOversamplingQuality:
+        return fRez.getOversamplerQuality();
+    case pIdCharacter:
+        return fRez.getFilterCharacter();
     default:
         DISTRHO_SAFE_ASSERT_RETURN(false, 0);
     }
@@ -111,51 +118,41 @@ void RezonateurPlugin::setParameterValue(uint32_t index, float value)
         fBypassed = value > 0.5f;
         break;
     case pIdMode:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterMode((int)value);
+        fRez.setFilterMode((int)value);
         break;
     case pIdOversampling:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setOversampling((unsigned)value);
+        fRez.setOversampling((unsigned)value);
+        setLatency(fRez.getLatency());
         break;
     case pIdGain1:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterGain(0, value);
+        fRez.setFilterGain(0, value);
         break;
     case pIdCutoff1:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterCutoff(0, value);
+        fRez.setFilterCutoff(0, value);
         break;
     case pIdEmph1:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterEmph(0, value);
+        fRez.setFilterEmph(0, value);
         break;
     case pIdGain2:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterGain(1, value);
+        fRez.setFilterGain(1, value);
         break;
     case pIdCutoff2:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterCutoff(1, value);
+        fRez.setFilterCutoff(1, value);
         break;
     case pIdEmph2:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterEmph(1, value);
+        fRez.setFilterEmph(1, value);
         break;
     case pIdGain3:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterGain(2, value);
+        fRez.setFilterGain(2, value);
         break;
     case pIdCutoff3:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterCutoff(2, value);
+        fRez.setFilterCutoff(2, value);
         break;
     case pIdEmph3:
-        for (unsigned c = 0; c < NumChannels; ++c)
-            fRez[c].setFilterEmph(2, value);
+        fRez.setFilterEmph(2, value);
         break;
     case pIdPreGain:
-        fPreGain = value;
+        fRez.setInputGain(value);
         break;
     case pIdDryGain:
         fDryGain = value;
@@ -163,58 +160,99 @@ void RezonateurPlugin::setParameterValue(uint32_t index, float value)
     case pIdWetGain:
         fWetGain = value;
         break;
+    case pIdOversamplerType:
+        fRez.setOversamplerType((int)value);
+        setLatency(fRez.getLatency());
+        break;
+    case pIdOversamplingQuality:
+        fRez.setOversamplerQuality((int)value);
+        setLatency(fRez.getLatency());
+        break;
+    case pIdCharacter:
+        fRez.setFilterCharacter((int)value);
+        break;
     default:
         DISTRHO_SAFE_ASSERT_RETURN(false,);
     }
 }
 
+void RezonateurPlugin::bufferSizeChanged(uint32_t newBufferSize)
+{
+    setBufferSize(newBufferSize);
+}
+
+void RezonateurPlugin::setBufferSize(uint32_t bufferSize)
+{
+    // the host sends blocks up to this size, they are processed whole
+    uint32_t limit = (bufferSize > 0) ? bufferSize : 256;
+    fRez.setMaximumBlockSize(limit);
+
+    // the dry signal is delayed to align with the oversampled wet signal
+    unsigned maxLatency = fRez.getMaximumLatency();
+    for (unsigned c = 0; c < NumChannels; ++c)
+        fDryDelay[c].resize(maxLatency + limit);
+    fDryInputs.reset(new float[NumChannels * limit]);
+    fDryLimit = limit;
+}
+
 void RezonateurPlugin::run(const float **inputs, float **outputs, uint32_t frames)
 {
+    const float *input[NumChannels];
+    float *output[NumChannels];
+    for (unsigned c = 0; c < NumChannels; ++c) {
+        input[c] = inputs[c];
+        output[c] = outputs[c];
+    }
+
+    while (frames > 0) {
+        uint32_t current = (frames < fDryLimit) ? frames : fDryLimit;
+        runWithinDryLimit(input, output, current);
+        for (unsigned c = 0; c < NumChannels; ++c) {
+            input[c] += current;
+            output[c] += current;
+        }
+        frames -= current;
+    }
+}
+
+void RezonateurPlugin::runWithinDryLimit(const float *const *inputs, float *const *outputs, uint32_t frames)
+{
+    // the same latency applies in bypass, so it does not jump when toggled
+    unsigned latency = fRez.getLatency();
+
+    // inputs and outputs may share memory, take the dry signal first
+    for (unsigned c = 0; c < NumChannels; ++c)
+        fDryDelay[c].write(inputs[c], frames);
+
     if (fBypassed) {
         for (unsigned c = 0; c < NumChannels; ++c) {
-            memcpy(outputs[c], inputs[c], frames * sizeof(float));
-            fOutputLevelFollower[c].clear();
-            fCurrentOutputLevel[c] = 0;
+            fDryDelay[c].read(outputs[c], frames, latency);
+            fOutputMeter[c].clear();
         }
         return;
     }
 
     WebCore::DenormalDisabler noDenormals;
 
-    float pre = fPreGain;
-    float dry = fDryGain;
-    float wet = fWetGain;
-
+    const float *dryInput[NumChannels];
     for (unsigned c = 0; c < NumChannels; ++c) {
-        Rezonateur &rez = fRez[c];
-        const float *input = inputs[c];
-        float *output = outputs[c];
-
-        for (unsigned i = 0; i < frames; ++i)
-            output[i] = pre * input[i];
-        rez.process(output, output, frames);
+        float *dryInputs = &fDryInputs[c * fDryLimit];
+        fDryDelay[c].read(dryInputs, frames, latency);
+        dryInput[c] = dryInputs;
+    }
 
-        AmpFollower &levelFollower = fOutputLevelFollower[c];
-        float level = fCurrentOutputLevel[c];
+    // the pre gain is at the input of the filters, and the mix is done in
+    // the last pass of the processing
+    fRez.process(inputs, outputs, frames, dryInput, fDryGain, fWetGain);
 
-        for (unsigned i = 0; i < frames; ++i) {
-            float out = dry * input[i] + wet * output[i];
-            level = levelFollower.process(out);
-            output[i] = out;
-        }
-
-        fCurrentOutputLevel[c] = level;
-    }
+    for (unsigned c = 0; c < NumChannels; ++c)
+        fOutputMeter[c].process(outputs[c], frames);
 }
 
-float RezonateurPlugin::getCurrentOutputLevel() const
+LevelMeter::Levels RezonateurPlugin::getOutputLevels(unsigned channel) const
 {
-    float level = fCurrentOutputLevel[0];
-    for (unsigned c = 1; c < NumChannels; ++c) {
-        float other = fCurrentOutputLevel[c];
-        level = (level > other) ? level : other;
-    }
-    return level;
+    DISTRHO_SAFE_ASSERT_RETURN(channel < NumChannels, LevelMeter::Levels());
+    return fOutputMeter[channel].getLevels();
 }
 
 ///
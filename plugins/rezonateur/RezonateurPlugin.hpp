@@ -2,7 +2,9 @@
 #include "DistrhoPlugin.hpp"
 #include "RezonateurShared.hpp"
 #include "Rezonateur.h"
-#include "dsp/AmpFollower.hpp"
+#include "dsp/LevelMeter.hpp"
+#include "dsp/DelayLine.h"
+#include <memory>
 #include <cstdint>
 
 class RezonateurPlugin : public Plugin {
@@ -27,16 +29,24 @@ public:
     float getParameterValue(uint32_t index) const override;
     void setParameterValue(uint32_t index, float value) override;
 
+    void bufferSizeChanged(uint32_t newBufferSize) override;
     void run(const float **inputs, float **outputs, uint32_t frames) override;
 
-    float getCurrentOutputLevel() const;
+    // the levels of an output channel, from any thread
+    LevelMeter::Levels getOutputLevels(unsigned channel) const;
+
+private:
+    void setBufferSize(uint32_t bufferSize);
+    void runWithinDryLimit(const float *const *inputs, float *const *outputs, uint32_t frames);
 
 private:
     bool fBypassed;
-    float fPreGain;
     float fDryGain;
     float fWetGain;
-    float fCurrentOutputLevel[NumChannels];
-    AmpFollower fOutputLevelFollower[NumChannels];
-    Rezonateur fRez[NumChannels];
+    LevelMeter fOutputMeter[NumChannels];
+    Rezonateur fRez;
+    DelayLine fDryDelay[NumChannels];
+    // the dry signal read back, for a block of the host
+    std::unique_ptr<float[]> fDryInputs;
+    uint32_t fDryLimit = 0;
 };
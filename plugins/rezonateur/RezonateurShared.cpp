@@ -29,15 +29,18 @@ void InitParameter(uint32_t index, Parameter &parameter)
         parameter.symbol = "oversampling";
         parameter.name = "Oversampling";
         parameter.hints = kParameterIsInteger;
-        parameter.ranges = ParameterRanges(1.0, 1.0, 8.0);
-        pev = new ParameterEnumerationValue[4];
+        parameter.ranges = ParameterRanges(1.0, 0.0, 32.0);
+        pev = new ParameterEnumerationValue[7];
         parameter.enumValues.values = pev;
-        parameter.enumValues.count = 4;
+        parameter.enumValues.count = 7;
         parameter.enumValues.restrictedMode = true;
-        pev[0] = ParameterEnumerationValue(1.0, u8"1×");
-        pev[1] = ParameterEnumerationValue(2.0, u8"2×");
-        pev[2] = ParameterEnumerationValue(4.0, u8"4×");
-        pev[3] = ParameterEnumerationValue(8.0, u8"8×");
+        pev[0] = ParameterEnumerationValue(0.0, "Auto");
+        pev[1] = ParameterEnumerationValue(1.0, u8"1×");
+        pev[2] = ParameterEnumerationValue(2.0, u8"2×");
+        pev[3] = ParameterEnumerationValue(4.0, u8"4×");
+        pev[4] = ParameterEnumerationValue(8.0, u8"8×");
+        pev[5] = ParameterEnumerationValue(16.0, u8"16×");
+        pev[6] = ParameterEnumerationValue(32.0, u8"32×");
         break;
 
     case pIdGain1:
@@ -118,6 +121,48 @@ void InitParameter(uint32_t index, Parameter &parameter)
         parameter.ranges = ParameterRanges(0.5, 0.01, 3.0);
         break;
 
+    case pIdOversamplerType:
+        parameter.symbol = "oversampler_type";
+        parameter.name = "Oversampling filter";
+        parameter.hints = kParameterIsInteger;
+        parameter.ranges = ParameterRanges(0.0, 0.0, 1.0);
+        pev = new ParameterEnumerationValue[2];
+        parameter.enumValues.values = pev;
+        parameter.enumValues.count = 2;
+        parameter.enumValues.restrictedMode = true;
+        pev[0] = ParameterEnumerationValue(0.0, "Linear phase");
+        pev[1] = ParameterEnumerationValue(1.0, "Low latency");
+        break;
+
+    case pIdOversamplingQuality:
+        parameter.symbol = "oversampling_quality";
+        parameter.name = "Oversampling quality";
+        parameter.hints = kParameterIsInteger;
+        parameter.ranges = ParameterRanges(1.0, 0.0, 2.0);
+        pev = new ParameterEnumerationValue[3];
+        parameter.enumValues.values = pev;
+        parameter.enumValues.count = 3;
+        parameter.enumValues.restrictedMode = true;
+        pev[0] = ParameterEnumerationValue(0.0, "Economy");
+        pev[1] = ParameterEnumerationValue(1.0, "Standard");
+        pev[2] = ParameterEnumerationValue(2.0, "High");
+        break;
+
+    case pIdCharacter:
+        parameter.symbol = "character";
+        parameter.name = "Character";
+        parameter.hints = kParameterIsInteger;
+        parameter.ranges = ParameterRanges(1.0, 0.0, 3.0);
+        pev = new ParameterEnumerationValue[4];
+        parameter.enumValues.values = pev;
+        parameter.enumValues.count = 4;
+        parameter.enumValues.restrictedMode = true;
+        pev[0] = ParameterEnumerationValue(0.0, "Linear");
+        pev[1] = ParameterEnumerationValue(1.0, "Saturating");
+        pev[2] = ParameterEnumerationValue(2.0, "Saturating, solved");
+        pev[3] = ParameterEnumerationValue(3.0, "Saturating, antialiased");
+        break;
+
     default:
         DISTRHO_SAFE_ASSERT(false);
     }
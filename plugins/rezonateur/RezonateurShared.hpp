@@ -27,6 +27,11 @@ enum {
     pIdDryGain,
     pIdWetGain,
 
+    pIdOversamplerType,
+    pIdOversamplingQuality,
+
+    pIdCharacter,
+
     ///
     Parameter_Count
 };
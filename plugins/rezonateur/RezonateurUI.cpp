@@ -7,6 +7,7 @@
 #include "components/SkinIndicator.hpp"
 #include "components/SkinSlider.hpp"
 #include "components/SkinToggleButton.hpp"
+#include "components/TextLabel.hpp"
 #include "utility/color.h"
 #include <cmath>
 
@@ -64,6 +65,9 @@ RezonateurUI::RezonateurUI()
     int xBandKnobs[3];
     int xWetDry;
     int xOversampling;
+    int xOversamplerType;
+    int xOversamplingQuality;
+    int xCharacter;
 
     int xOffPassMode = -12;
     int xOffOversampling = -12;
@@ -107,6 +111,15 @@ RezonateurUI::RezonateurUI()
     sx += 50;
     xOversampling = sx;
     createSliderForParameter(fSkinBlackKnob, pIdOversampling, sx, sy);
+    sx += 60;
+    xOversamplerType = sx;
+    createSliderForParameter(fSkinBlackKnob, pIdOversamplerType, sx, sy);
+    sx += 60;
+    xOversamplingQuality = sx;
+    createSliderForParameter(fSkinBlackKnob, pIdOversamplingQuality, sx, sy);
+    sx += 60;
+    xCharacter = sx;
+    createSliderForParameter(fSkinBlackKnob, pIdCharacter, sx, sy);
 
     SkinIndicator *label;
     ///
@@ -147,6 +160,13 @@ RezonateurUI::RezonateurUI()
     fMiscWidgets.push_back(std::unique_ptr<Widget>(label));
     label->setAbsolutePos(xWetDry + xOffPreWetDry, 360);
     ///
+    static const char *const typeNames[] = {"FIR", "IIR"};
+    createSelectorLabels("FILTER", typeNames, 2, xOversamplerType, sy);
+    static const char *const qualityNames[] = {"ECO", "STD", "HIGH"};
+    createSelectorLabels("QUALITY", qualityNames, 3, xOversamplingQuality, sy);
+    static const char *const characterNames[] = {"LIN", "SAT", "SOLV", "AA"};
+    createSelectorLabels("CHARACTER", characterNames, 4, xCharacter, sy);
+    ///
 
     SkinIndicator *levelMonitor = new SkinIndicator(fSkinLevelMonitor, this);
     fLevelMonitor.reset(levelMonitor);
@@ -157,7 +177,7 @@ RezonateurUI::~RezonateurUI()
 {
 }
 
-const unsigned RezonateurUI::ui_width = 610;
+const unsigned RezonateurUI::ui_width = 790;
 const unsigned RezonateurUI::ui_height = 500;
 
 void RezonateurUI::onDisplay()
@@ -200,7 +220,13 @@ void RezonateurUI::parameterChanged(uint32_t index, float value)
 void RezonateurUI::uiIdle()
 {
     RezonateurPlugin *dsp = (RezonateurPlugin *)getPluginInstancePointer();
-    float level = dsp->getCurrentOutputLevel();
+
+    // the held peak of the loudest channel
+    float level = 0;
+    for (unsigned c = 0; c < DISTRHO_PLUGIN_NUM_OUTPUTS; ++c) {
+        float hold = dsp->getOutputLevels(c).hold;
+        level = (hold > level) ? hold : level;
+    }
     fLevelMonitor->setValue(level);
 }
 
@@ -276,6 +302,24 @@ void RezonateurUI::createSliderForParameter(const KnobSkin &skin, int pid, int x
         };
 }
 
+void RezonateurUI::createSelectorLabels(const char *title, const char *const names[], unsigned count, int x, int y)
+{
+    TextLabel *label = new TextLabel(title, this);
+    fMiscWidgets.push_back(std::unique_ptr<Widget>(label));
+    label->setSize(60, 16);
+    label->setAbsolutePos(x - 12, 360);
+
+    // the choices beside the knob, at the heights of its positions,
+    // the first at the bottom
+    for (unsigned nth = 0; nth < count; ++nth) {
+        label = new TextLabel(names[nth], this);
+        fMiscWidgets.push_back(std::unique_ptr<Widget>(label));
+        label->setFontSize(7.0);
+        double position = (count > 1) ? (1.0 - (double)nth / (count - 1)) : 0.0;
+        label->setAbsolutePos(x + 20, y - 4 + (int)std::lround(position * 76));
+    }
+}
+
 void RezonateurUI::createToggleButtonForParameter(const KnobSkin &skin, int pid, int x, int y)
 {
     DISTRHO_SAFE_ASSERT_RETURN(pid < Parameter_Count,);
@@ -306,6 +350,15 @@ double RezonateurUI::convertNormalizedToParameter(unsigned index, double value)
     double min = param.ranges.min;
     double max = param.ranges.max;
 
+    const ParameterEnumerationValues &enumValues = param.enumValues;
+    if (enumValues.restrictedMode && enumValues.count > 1) {
+        // enumerations are evenly spaced on the knob
+        long nth = std::lround(value * (enumValues.count - 1));
+        nth = (nth < 0) ? 0 : nth;
+        nth = (nth < (long)enumValues.count) ? nth : (long)(enumValues.count - 1);
+        return enumValues.values[nth].value;
+    }
+
     if (param.hints & kParameterIsLogarithmic)
         value = min * std::pow(max / min, value);
     else
@@ -325,6 +378,14 @@ double RezonateurUI::convertNormalizedFromParameter(unsigned index, double value
     double min = param.ranges.min;
     double max = param.ranges.max;
 
+    const ParameterEnumerationValues &enumValues = param.enumValues;
+    if (enumValues.restrictedMode && enumValues.count > 1) {
+        for (unsigned nth = 0; nth < enumValues.count; ++nth) {
+            if (enumValues.values[nth].value == value)
+                return (double)nth / (enumValues.count - 1);
+        }
+    }
+
     if (param.hints & kParameterIsLogarithmic)
         value = std::log(value / min) / std::log(max / min);
     else
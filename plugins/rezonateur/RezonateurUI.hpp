@@ -28,6 +28,7 @@ private:
     void updateParameterValue(uint32_t index, float value);
     void createSliderForParameter(const KnobSkin &skin, int pid, int x, int y);
     void createToggleButtonForParameter(const KnobSkin &skin, int pid, int x, int y);
+    void createSelectorLabels(const char *title, const char *const names[], unsigned count, int x, int y);
 
     double convertNormalizedToParameter(unsigned index, double value);
     double convertNormalizedFromParameter(unsigned index, double value);
@@ -125,6 +125,8 @@ void ResponseView::recomputeResponseCache()
 
     DISTRHO_SAFE_ASSERT_RETURN(size > 0,);
 
+    rez.updateCoefficients();
+
     fResponse.resize(size);
     double *response = fResponse.data();
 
@@ -0,0 +1,45 @@
+#include "TextLabel.hpp"
+#include "Window.hpp"
+#include "Cairo.hpp"
+
+TextLabel::TextLabel(const char *text, Widget *group)
+    : Widget(group), fText(text)
+{
+    setSize(40, 16);
+}
+
+void TextLabel::setText(const char *text)
+{
+    if (fText == text)
+        return;
+
+    fText = text;
+    repaint();
+}
+
+void TextLabel::setFontSize(double size)
+{
+    if (fFontSize == size)
+        return;
+
+    fFontSize = size;
+    repaint();
+}
+
+void TextLabel::onDisplay()
+{
+    cairo_t *cr = getParentWindow().getGraphicsContext().cairo;
+
+    int h = getHeight();
+
+    // the color of the text in the artwork
+    cairo_select_font_face(cr, "sans-serif", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, fFontSize);
+    cairo_set_source_rgba(cr, 0xfd / 255.0, 0xfd / 255.0, 0xfd / 255.0, 1.0);
+
+    // centered vertically
+    cairo_font_extents_t extents;
+    cairo_font_extents(cr, &extents);
+    cairo_move_to(cr, 0, 0.5 * (h + extents.ascent - extents.descent));
+    cairo_show_text(cr, fText.c_str());
+}
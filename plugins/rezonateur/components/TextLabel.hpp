@@ -0,0 +1,18 @@
+#pragma once
+#include "Widget.hpp"
+#include <string>
+
+// A line of text, for the labels which have no artwork
+class TextLabel : public Widget {
+public:
+    TextLabel(const char *text, Widget *group);
+
+    void setText(const char *text);
+    void setFontSize(double size);
+
+    void onDisplay() override;
+
+private:
+    std::string fText;
+    double fFontSize = 8.0;
+};
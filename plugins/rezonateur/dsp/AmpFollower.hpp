@@ -12,6 +12,8 @@ struct AmpFollower
     double mem_ = 0;
     void release(double t); // t = fs * release time
     double process(double x);
+    // follows a block of `n` samples, given its peak
+    double processPeak(double peak, unsigned n);
     void clear();
 };
 
@@ -33,6 +35,17 @@ inline double AmpFollower::process(double x)
     return y;
 }
 
+inline double AmpFollower::processPeak(double peak, unsigned n)
+{
+    // the release over the block, toward its peak
+    double p = std::pow(p_, (double)n);
+    double mem = mem_;
+    double rel = p * mem + (1.0 - p) * peak;
+    double y = (peak > mem) ? peak : rel;
+    mem_ = y;
+    return y;
+}
+
 inline void AmpFollower::clear()
 {
     mem_ = 0;
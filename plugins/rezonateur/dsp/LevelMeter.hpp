@@ -0,0 +1,99 @@
+#pragma once
+#include "AmpFollower.hpp"
+#include <atomic>
+#include <cmath>
+
+// Meter of the peak and RMS levels of a channel, which follows them once
+// per block, and publishes them for another thread to read.
+// The held peak stays at the highest for the hold time, then follows the
+// peak down.
+class LevelMeter {
+public:
+    struct Levels {
+        float peak;
+        float rms;
+        float hold;
+    };
+
+    void init(double samplerate);
+    void clear();
+    void process(const float *x, unsigned n);
+    // from any thread
+    Levels getLevels() const;
+
+private:
+    AmpFollower fPeakFollower;
+    double fPower = 0;
+    double fPowerPole = 0;
+    float fHold = 0;
+    unsigned fHoldRemaining = 0;
+    unsigned fHoldLength = 0;
+
+    std::atomic<float> fSharedPeak{0};
+    std::atomic<float> fSharedRms{0};
+    std::atomic<float> fSharedHold{0};
+
+    static constexpr double sReleaseTime = 0.5;
+    static constexpr double sRmsTime = 0.3;
+    static constexpr double sHoldTime = 1.0;
+};
+
+//------------------------------------------------------------------------------
+inline void LevelMeter::init(double samplerate)
+{
+    fPeakFollower.release(sReleaseTime * samplerate);
+    fPowerPole = std::exp(-1.0 / (sRmsTime * samplerate));
+    fHoldLength = (unsigned)(sHoldTime * samplerate);
+    clear();
+}
+
+inline void LevelMeter::clear()
+{
+    fPeakFollower.clear();
+    fPower = 0;
+    fHold = 0;
+    fHoldRemaining = 0;
+    fSharedPeak.store(0, std::memory_order_relaxed);
+    fSharedRms.store(0, std::memory_order_relaxed);
+    fSharedHold.store(0, std::memory_order_relaxed);
+}
+
+inline void LevelMeter::process(const float *x, unsigned n)
+{
+    if (n == 0)
+        return;
+
+    // reductions without dependency between the samples, which vectorize
+    float peak = 0;
+    float sum = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        float a = std::fabs(x[i]);
+        peak = (a > peak) ? a : peak;
+        sum += x[i] * x[i];
+    }
+
+    float level = fPeakFollower.processPeak(peak, n);
+
+    double p = std::pow(fPowerPole, (double)n);
+    fPower = p * fPower + (1.0 - p) * (sum / n);
+
+    if (level >= fHold || fHoldRemaining <= n) {
+        fHoldRemaining = (level >= fHold) ? fHoldLength : 0;
+        fHold = level;
+    }
+    else
+        fHoldRemaining -= n;
+
+    fSharedPeak.store(level, std::memory_order_relaxed);
+    fSharedRms.store((float)std::sqrt(fPower), std::memory_order_relaxed);
+    fSharedHold.store(fHold, std::memory_order_relaxed);
+}
+
+inline LevelMeter::Levels LevelMeter::getLevels() const
+{
+    Levels levels;
+    levels.peak = fSharedPeak.load(std::memory_order_relaxed);
+    levels.rms = fSharedRms.load(std::memory_order_relaxed);
+    levels.hold = fSharedHold.load(std::memory_order_relaxed);
+    return levels;
+}
@@ -1,19 +1,31 @@
 #include "Rezonateur.h"
 #include <cstring>
+#include <cmath>
+#include <utility>
 #include <cassert>
 
-void Rezonateur::init(double samplerate)
+void Rezonateur::init(double samplerate, unsigned channels)
 {
-    allocateWorkBuffers(3 * MaximumOversampling);
+    assert(channels > 0 && channels <= MaximumChannels);
+    fNumChannels = channels;
+    fSampleRate = samplerate;
+
+    resizeDelays();
 
     int mode = LowpassMode;
     int ftype = getFilterTypeForMode(mode);
 
     fMode = mode;
     fOversampling = 1;
+    fOversamplerType = FIROversamplerType;
+    fOversamplerQuality = StandardQuality;
+    fAutoOversampling = false;
+    fArena.reserve(getMaximumArenaSize());
+    fArenaType = -1;
+    setupArena();
 
     for (unsigned i = 0; i < 3; ++i)
-        fFilterGains[i] = 1.0;
+        fFilterGains[i] = fTargetGains[i] = 1.0;
 
     const double cutoffs[] = {300.0, 1800.0, 7600.0};
     const double q = 10.0;
@@ -22,11 +34,57 @@ void Rezonateur::init(double samplerate)
         VAStateVariableFilter &filter = fFilters[i];
         filter.setSampleRate(samplerate);
         filter.setFilterType(ftype);
-        filter.setCutoffFreq(fFilterCutoffFreqs[i] = cutoffs[i]);
-        filter.setQ(fFilterQ[i] = q);
+        filter.setCutoffFreq(fFilterCutoffFreqs[i] = fTargetCutoffFreqs[i] = cutoffs[i]);
+        filter.setQ(fFilterQ[i] = fTargetQ[i] = q);
+    }
+    fDirtyBands = 0;
+    fIntervalRemaining = sControlInterval;
+    fIntervalRamping = false;
+
+    // a one-pole approach of the targets, advanced once per interval
+    fSmoothing = 1.0 - std::exp(-(double)sControlInterval / (sSmoothingTime * samplerate));
+
+    fFilterBank.setNumChannels(channels);
+    fFilterBank.setFilterType(ftype);
+    fFadeBank.setNumChannels(channels);
+#if REZONATEUR_SINGLE_PRECISION
+    setFilterPrecision(SinglePrecision);
+#else
+    setFilterPrecision(DoublePrecision);
+#endif
+    updateFilterBank();
+}
+
+void Rezonateur::setMaximumBlockSize(unsigned size)
+{
+    assert(size > 0);
+    if (fMaximumBlockSize == size)
+        return;
+
+    fMaximumBlockSize = size;
+    resizeDelays();
+    fArena.reserve(getMaximumArenaSize());
+    fArenaType = -1;
+    setupArena();
+    flush();
+}
+
+void Rezonateur::resizeDelays()
+{
+    // the chunks are the longest with the work buffers of the base rate
+    unsigned capacity = getMaximumLatency() + getBufferLimit(1);
+    for (unsigned c = 0; c < fNumChannels; ++c) {
+        fLowBandDelay[c].resize(capacity);
+        fAutoPadding[c].resize(capacity);
+        fFadePadding[c].resize(capacity);
     }
 }
 
+unsigned Rezonateur::getNumChannels() const
+{
+    return fNumChannels;
+}
+
 void Rezonateur::setFilterMode(int mode)
 {
     int ftype = getFilterTypeForMode(mode);
@@ -36,26 +94,124 @@ void Rezonateur::setFilterMode(int mode)
     for (unsigned i = 0; i < 3; ++i) {
         VAStateVariableFilter &filter = fFilters[i];
         filter.setFilterType(ftype);
-        filter.clear();
     }
+
+    cancelAutoFade();
+    fFilterBank.setFilterType(ftype);
+    fFilterBank.clear();
+    updateFilterBank();
 }
 
 void Rezonateur::setFilterGain(unsigned nth, float gain)
 {
     assert(nth < 3);
-    fFilterGains[nth] = gain;
+    if (fTargetGains[nth] == gain)
+        return;
+    fTargetGains[nth] = gain;
+    fDirtyBands |= 1u << nth;
 }
 
 void Rezonateur::setFilterCutoff(unsigned nth, float cutoff)
 {
     assert(nth < 3);
-    fFilters[nth].setCutoffFreq((fFilterCutoffFreqs[nth] = cutoff) / fOversampling);
+    if (fTargetCutoffFreqs[nth] == cutoff)
+        return;
+    fTargetCutoffFreqs[nth] = cutoff;
+    fDirtyBands |= 1u << nth;
 }
 
 void Rezonateur::setFilterEmph(unsigned nth, float emph)
 {
     assert(nth < 3);
-    fFilters[nth].setQ(fFilterQ[nth] = emph);
+    if (fTargetQ[nth] == emph)
+        return;
+    fTargetQ[nth] = emph;
+    fDirtyBands |= 1u << nth;
+}
+
+void Rezonateur::setBand(unsigned nth, float gain, float cutoff, float emph)
+{
+    assert(nth < 3);
+    if (fTargetGains[nth] == gain && fTargetCutoffFreqs[nth] == cutoff && fTargetQ[nth] == emph)
+        return;
+    fTargetGains[nth] = gain;
+    fTargetCutoffFreqs[nth] = cutoff;
+    fTargetQ[nth] = emph;
+    fDirtyBands |= 1u << nth;
+}
+
+void Rezonateur::setInputGain(float gain)
+{
+    if (fTargetInputGain == gain)
+        return;
+
+    fTargetInputGain = gain;
+    fDirtyBands = AllBands;
+}
+
+float Rezonateur::getInputGain() const
+{
+    return fTargetInputGain;
+}
+
+void Rezonateur::updateCoefficients()
+{
+    unsigned bands = fDirtyBands;
+    if (bands == 0)
+        return;
+
+    fInputGain = fTargetInputGain;
+
+    for (unsigned b = 0; b < 3; ++b) {
+        if (bands & (1u << b)) {
+            fFilterGains[b] = fTargetGains[b];
+            fFilterCutoffFreqs[b] = fTargetCutoffFreqs[b];
+            fFilterQ[b] = fTargetQ[b];
+            fFilters[b].setCutoffFreqAndQ(fFilterCutoffFreqs[b] / fOversampling, fFilterQ[b]);
+        }
+    }
+
+    updateFilterBank(bands);
+    fDirtyBands = 0;
+    fIntervalRamping = false;
+}
+
+void Rezonateur::advanceSmoothing()
+{
+    // cutoff and Q move on a logarithmic scale, and stop when close enough
+    // that the rest of the way makes no audible step
+    const double smoothing = fSmoothing;
+    const unsigned bands = fDirtyBands;
+
+    // the input gain moves all the bands
+    double di = fTargetInputGain - fInputGain;
+    bool inputSettled = std::fabs(di) < 1e-4;
+    fInputGain = inputSettled ? fTargetInputGain : (fInputGain + smoothing * di);
+
+    for (unsigned b = 0; b < 3; ++b) {
+        if (!(bands & (1u << b)))
+            continue;
+
+        double dc = std::log(fTargetCutoffFreqs[b] / fFilterCutoffFreqs[b]);
+        double dq = std::log(fTargetQ[b] / fFilterQ[b]);
+        double dg = fTargetGains[b] - fFilterGains[b];
+
+        if (inputSettled && std::fabs(dc) < 1e-3 && std::fabs(dq) < 1e-3 && std::fabs(dg) < 1e-4) {
+            fFilterGains[b] = fTargetGains[b];
+            fFilterCutoffFreqs[b] = fTargetCutoffFreqs[b];
+            fFilterQ[b] = fTargetQ[b];
+            fDirtyBands &= ~(1u << b);
+        }
+        else {
+            fFilterGains[b] += smoothing * dg;
+            fFilterCutoffFreqs[b] *= std::exp(smoothing * dc);
+            fFilterQ[b] *= std::exp(smoothing * dq);
+        }
+
+        fFilters[b].setCutoffFreqAndQ(fFilterCutoffFreqs[b] / fOversampling, fFilterQ[b]);
+    }
+
+    updateFilterBank(bands, true);
 }
 
 int Rezonateur::getFilterMode() const
@@ -66,24 +222,24 @@ int Rezonateur::getFilterMode() const
 float Rezonateur::getFilterGain(unsigned nth) const
 {
     assert(nth < 3);
-    return fFilterGains[nth];
+    return fTargetGains[nth];
 }
 
 float Rezonateur::getFilterCutoff(unsigned nth) const
 {
     assert(nth < 3);
-    return fFilterCutoffFreqs[nth];
+    return fTargetCutoffFreqs[nth];
 }
 
 float Rezonateur::getFilterEmph(unsigned nth) const
 {
     assert(nth < 3);
-    return fFilterQ[nth];
+    return fTargetQ[nth];
 }
 
 unsigned Rezonateur::getOversampling() const
 {
-    return fOversampling;
+    return fAutoOversampling ? (unsigned)AutoOversampling : fOversampling;
 }
 
 void Rezonateur::setOversampling(unsigned oversampling)
@@ -91,108 +247,916 @@ void Rezonateur::setOversampling(unsigned oversampling)
     switch (oversampling) {
     default:
         assert(false);
-        /* fall through */
-    case 1:
         oversampling = 1;
-        if (fOversampling == oversampling)
-            return;
         break;
+    case AutoOversampling:
+    case 1:
     case 2:
-        oversampling = 2;
-        if (fOversampling == oversampling)
-            return;
-        fOversampler2x.reset();
-        break;
     case 4:
-        oversampling = 4;
-        if (fOversampling == oversampling)
-            return;
-        fOversampler4x.reset();
-        break;
     case 8:
-        oversampling = 8;
-        if (fOversampling == oversampling)
-            return;
-        fOversampler8x.reset();
+    case 16:
+    case 32:
         break;
     }
 
+    if (getOversampling() == oversampling)
+        return;
+
+    cancelAutoFade();
+
+    // automatic mode starts from the current ratio
+    fAutoOversampling = oversampling == AutoOversampling;
+    for (unsigned c = 0; c < fNumChannels; ++c)
+        fAutoPadding[c].clear();
+    if (fAutoOversampling) {
+        fAutoHold = 0;
+        fAutoPeak = 0;
+        // the oversamplers are placed anew with the other ratios
+        if (setupArena()) {
+            resetOversampler(fOversampling);
+            fFilterBank.clear();
+        }
+        // the low band leaves the base rate
+        updateFilterBank();
+        return;
+    }
+
     fOversampling = oversampling;
 
     for (unsigned b = 0; b < 3; ++b) {
         VAStateVariableFilter &filter = fFilters[b];
         filter.setCutoffFreq(fFilterCutoffFreqs[b] / oversampling);
-        filter.clear();
+    }
+
+    setupArena();
+    resetOversampler(oversampling);
+    fFilterBank.clear();
+    updateFilterBank();
+}
+
+int Rezonateur::getOversamplerType() const
+{
+    return fOversamplerType;
+}
+
+void Rezonateur::setOversamplerType(int type)
+{
+    switch (type) {
+    default:
+        assert(false);
+        type = FIROversamplerType;
+        break;
+    case FIROversamplerType:
+    case IIROversamplerType:
+        break;
+    }
+
+    if (fOversamplerType == type)
+        return;
+
+    fOversamplerType = type;
+
+    cancelAutoFade();
+    setupArena();
+    resetOversampler(fOversampling);
+    fFilterBank.clear();
+    updateFilterBank();
+}
+
+int Rezonateur::getOversamplerQuality() const
+{
+    return fOversamplerQuality;
+}
+
+void Rezonateur::setOversamplerQuality(int quality)
+{
+    switch (quality) {
+    default:
+        assert(false);
+        quality = StandardQuality;
+        break;
+    case EconomyQuality:
+    case StandardQuality:
+    case HighQuality:
+        break;
+    }
+
+    if (fOversamplerQuality == quality)
+        return;
+
+    fOversamplerQuality = quality;
+
+    cancelAutoFade();
+    setupArena();
+    resetOversampler(fOversampling);
+    fFilterBank.clear();
+}
+
+int Rezonateur::getFilterPrecision() const
+{
+    return fFilterBank.getPrecision();
+}
+
+void Rezonateur::setFilterPrecision(int precision)
+{
+    switch (precision) {
+    default:
+        assert(false);
+        precision = DoublePrecision;
+        break;
+    case DoublePrecision:
+    case SinglePrecision:
+        break;
+    }
+
+    // the states are kept in double, they carry over
+    fFilterBank.setPrecision(precision);
+    fFadeBank.setPrecision(precision);
+}
+
+int Rezonateur::getFilterCharacter() const
+{
+    return fFilterBank.getCharacter();
+}
+
+void Rezonateur::setFilterCharacter(int character)
+{
+    switch (character) {
+    default:
+        assert(false);
+        character = SaturatingCharacter;
+        break;
+    case LinearCharacter:
+    case SaturatingCharacter:
+    case ImplicitCharacter:
+    case AntialiasedCharacter:
+        break;
+    }
+
+    if (fFilterBank.getCharacter() == character)
+        return;
+
+    // the states of a model are not those of another
+    cancelAutoFade();
+    fFilterBank.setCharacter(character);
+    fFadeBank.setCharacter(character);
+    fFilterBank.clear();
+}
+
+unsigned Rezonateur::getLatency() const
+{
+    if (!fAutoOversampling)
+        return getLatency(fOversamplerType, fOversamplerQuality, fOversampling);
+
+    // all ratios are padded to the latency of the longest
+    unsigned latency = 0;
+    for (unsigned ratio = 2; ratio <= MaximumOversampling; ratio *= 2) {
+        unsigned current = getLatency(fOversamplerType, fOversamplerQuality, ratio);
+        latency = (current > latency) ? current : latency;
+    }
+    return latency;
+}
+
+unsigned Rezonateur::getMaximumLatency() const
+{
+    unsigned latency = 0;
+    for (int type : {FIROversamplerType, IIROversamplerType}) {
+        for (int quality : {EconomyQuality, StandardQuality, HighQuality}) {
+            for (unsigned ratio = 2; ratio <= MaximumOversampling; ratio *= 2) {
+                unsigned current = getLatency(type, quality, ratio);
+                latency = (current > latency) ? current : latency;
+            }
+        }
+    }
+    return latency;
+}
+
+unsigned Rezonateur::getLatency(int type, int quality, unsigned ratio) const
+{
+    bool iir = type == IIROversamplerType;
+
+    switch (quality) {
+    case EconomyQuality:
+        return iir ? fEconomyOversamplers.fIIR.getLatency(ratio) :
+            fEconomyOversamplers.fFIR.getLatency(ratio);
+    default:
+    case StandardQuality:
+        return iir ? fStandardOversamplers.fIIR.getLatency(ratio) :
+            fStandardOversamplers.fFIR.getLatency(ratio);
+    case HighQuality:
+        return iir ? fHighOversamplers.fIIR.getLatency(ratio) :
+            fHighOversamplers.fFIR.getLatency(ratio);
+    }
+}
+
+bool Rezonateur::isLowBandMultirate() const
+{
+    // The low band runs at the base rate, the others are oversampled. The
+    // sum is exact only if the oversampler delays all frequencies alike.
+    // In automatic mode, the ratio changes too often for the low band to
+    // follow, and it runs at the lowest sufficient ratio already.
+    return fOversampling > 1 && fOversamplerType == FIROversamplerType &&
+        !fAutoOversampling;
+}
+
+void Rezonateur::resetOversampler(unsigned ratio)
+{
+    for (unsigned c = 0; c < fNumChannels; ++c)
+        fLowBandDelay[c].clear();
+
+    bool iir = fOversamplerType == IIROversamplerType;
+    unsigned channels = fNumChannels;
+
+    switch (fOversamplerQuality) {
+    case EconomyQuality:
+        if (iir)
+            fEconomyOversamplers.fIIR.reset(ratio, channels);
+        else
+            fEconomyOversamplers.fFIR.reset(ratio, channels);
+        break;
+    default:
+    case StandardQuality:
+        if (iir)
+            fStandardOversamplers.fIIR.reset(ratio, channels);
+        else
+            fStandardOversamplers.fFIR.reset(ratio, channels);
+        break;
+    case HighQuality:
+        if (iir)
+            fHighOversamplers.fIIR.reset(ratio, channels);
+        else
+            fHighOversamplers.fFIR.reset(ratio, channels);
+        break;
     }
 }
 
 void Rezonateur::process(const float *input, float *output, unsigned count)
 {
-    switch (fOversampling) {
+    assert(fNumChannels == 1);
+    process(&input, &output, count);
+}
+
+void Rezonateur::process(const float *const *inputs, float *const *outputs, unsigned count)
+{
+    processMixed(inputs, outputs, count, nullptr);
+}
+
+void Rezonateur::process(const float *const *inputs, float *const *outputs, unsigned count, const float *const *dryInputs, float dry, float wet)
+{
+    Mix mix;
+    for (unsigned c = 0; c < fNumChannels; ++c)
+        mix.inputs[c] = dryInputs[c];
+    mix.dry = dry;
+    mix.wet = wet;
+    processMixed(inputs, outputs, count, &mix);
+}
+
+Rezonateur::Mix Rezonateur::Mix::advance(unsigned count, unsigned channels) const
+{
+    Mix next = *this;
+    for (unsigned c = 0; c < channels; ++c)
+        next.inputs[c] += count;
+    return next;
+}
+
+void Rezonateur::processMixed(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    const unsigned channels = fNumChannels;
+
+    const float *input[MaximumChannels];
+    float *output[MaximumChannels];
+    for (unsigned c = 0; c < channels; ++c) {
+        input[c] = inputs[c];
+        output[c] = outputs[c];
+    }
+
+    // without its memory, the filter is muted
+    if (!fArenaPlaced) {
+        for (unsigned c = 0; c < channels; ++c)
+            std::memset(output[c], 0, count * sizeof(float));
+        mixOutputs(output, nullptr, count, mix);
+        return;
+    }
+
+    Mix currentMix;
+    if (mix)
+        currentMix = *mix;
+
+    while (count > 0) {
+        unsigned current = fIdle ?
+            processIdle(input, output, count, mix ? &currentMix : nullptr) :
+            processActive(input, output, count, mix ? &currentMix : nullptr);
+        for (unsigned c = 0; c < channels; ++c) {
+            input[c] += current;
+            output[c] += current;
+        }
+        if (mix)
+            currentMix = currentMix.advance(current, channels);
+        count -= current;
+    }
+}
+
+unsigned Rezonateur::processIdle(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    // the states are zero, the processing resumes from the first sample
+    // which is heard
+    unsigned current = getSilentLength(inputs, count);
+    if (current < count)
+        fIdle = false;
+    if (current == 0)
+        return 0;
+
+    // the settings move as they would over a processed silence, so they
+    // are where expected when the sound comes back
+    skipSmoothing(current);
+    for (unsigned c = 0; c < fNumChannels; ++c)
+        std::memset(outputs[c], 0, current * sizeof(float));
+    mixOutputs(outputs, nullptr, current, mix);
+    return current;
+}
+
+unsigned Rezonateur::processActive(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    // up to the last sample heard, the block goes at once
+    unsigned heard = count - getSilentTail(inputs, count);
+    if (heard > 0) {
+        processFiltered(inputs, outputs, heard, mix);
+        fQuietLength = 0;
+        fIntervalQuiet = fIntervalRemaining == sControlInterval;
+        return heard;
+    }
+
+    // The input is silent, the tail is checked over every control
+    // interval, on the filtered signal before the mix. Once the states and
+    // the output have stayed under the threshold for long enough that all
+    // the oversamplers and the delays hold was produced from them, the
+    // states are flushed. A FIR spans twice its latency.
+    unsigned current = (count < fIntervalRemaining) ? count : fIntervalRemaining;
+    processFiltered(inputs, outputs, current, nullptr);
+    fIntervalQuiet = fIntervalQuiet && isQuiet(outputs, current);
+    mixOutputs(outputs, nullptr, current, mix);
+
+    if (fIntervalRemaining == sControlInterval) {
+        bool quiet = fIntervalQuiet && fFadeRatio == 0;
+        for (unsigned c = 0; c < fNumChannels && quiet; ++c)
+            quiet = fFilterBank.getStateMagnitude(c) <= sSilenceThreshold;
+        fQuietLength = quiet ? (fQuietLength + sControlInterval) : 0;
+        fIntervalQuiet = true;
+
+        if (fQuietLength > 2 * getLatency()) {
+            flush();
+            fIdle = true;
+        }
+    }
+
+    return current;
+}
+
+void Rezonateur::processFiltered(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    if (fDirtyBands == 0 && !fIntervalRamping) {
+        processBlock(inputs, outputs, count, mix);
+        advanceInterval(count);
+    }
+    else
+        processSmoothly(inputs, outputs, count, mix);
+}
+
+void Rezonateur::processBlock(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    if (fAutoOversampling)
+        processAuto(inputs, outputs, count, mix);
+    else
+        processWithRatio(fOversampling, fFilterBank, inputs, outputs, count, mix);
+}
+
+void Rezonateur::processSmoothly(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    const unsigned channels = fNumChannels;
+
+    const float *input[MaximumChannels];
+    float *output[MaximumChannels];
+    for (unsigned c = 0; c < channels; ++c) {
+        input[c] = inputs[c];
+        output[c] = outputs[c];
+    }
+
+    Mix currentMix;
+    if (mix)
+        currentMix = *mix;
+
+    // the settings move at the start of every interval, until they reach
+    // their targets. An interval goes on in the next block if this one ends
+    // first, so the result does not depend on where the blocks are split.
+    while (count > 0 && (fDirtyBands != 0 || fIntervalRamping)) {
+        if (fIntervalRemaining == sControlInterval && fDirtyBands != 0) {
+            advanceSmoothing();
+            fIntervalRamping = true;
+        }
+
+        unsigned current = (count < fIntervalRemaining) ? count : fIntervalRemaining;
+        if (fIntervalRamping) {
+            unsigned begin = sControlInterval - fIntervalRemaining;
+            fFilterBank.setRampSpan(begin, begin + current, sControlInterval);
+            if (fFadeRatio != 0)
+                fFadeBank.setRampSpan(begin, begin + current, sControlInterval);
+        }
+        processBlock(input, output, current, mix ? &currentMix : nullptr);
+        advanceInterval(current);
+        for (unsigned c = 0; c < channels; ++c) {
+            input[c] += current;
+            output[c] += current;
+        }
+        if (mix)
+            currentMix = currentMix.advance(current, channels);
+        count -= current;
+    }
+
+    if (count > 0) {
+        processBlock(input, output, count, mix ? &currentMix : nullptr);
+        advanceInterval(count);
+    }
+}
+
+void Rezonateur::skipSmoothing(unsigned count)
+{
+    // as processSmoothly, without processing
+    while (count > 0 && (fDirtyBands != 0 || fIntervalRamping)) {
+        if (fIntervalRemaining == sControlInterval && fDirtyBands != 0) {
+            advanceSmoothing();
+            fIntervalRamping = true;
+        }
+
+        unsigned current = (count < fIntervalRemaining) ? count : fIntervalRemaining;
+        if (fIntervalRamping) {
+            unsigned begin = sControlInterval - fIntervalRemaining;
+            fFilterBank.setRampSpan(begin, begin + current, sControlInterval);
+            fFilterBank.skipRamp();
+            if (fFadeRatio != 0) {
+                fFadeBank.setRampSpan(begin, begin + current, sControlInterval);
+                fFadeBank.skipRamp();
+            }
+        }
+        advanceInterval(current);
+        count -= current;
+    }
+
+    advanceInterval(count);
+}
+
+void Rezonateur::advanceInterval(unsigned count)
+{
+    unsigned remaining = fIntervalRemaining;
+    if (count < remaining) {
+        fIntervalRemaining = remaining - count;
+        return;
+    }
+
+    // the ramp ends with its interval
+    fIntervalRemaining = sControlInterval - (count - remaining) % sControlInterval;
+    fIntervalRamping = false;
+}
+
+unsigned Rezonateur::getSilentLength(const float *const *inputs, unsigned count) const
+{
+    unsigned length = count;
+
+    for (unsigned c = 0; c < fNumChannels; ++c) {
+        const float *input = inputs[c];
+        unsigned i = 0;
+        while (i < length && std::fabs(input[i]) <= sSilenceThreshold)
+            ++i;
+        length = i;
+    }
+
+    return length;
+}
+
+unsigned Rezonateur::getSilentTail(const float *const *inputs, unsigned count) const
+{
+    unsigned length = count;
+
+    for (unsigned c = 0; c < fNumChannels; ++c) {
+        const float *input = inputs[c];
+        unsigned i = 0;
+        while (i < length && std::fabs(input[count - 1 - i]) <= sSilenceThreshold)
+            ++i;
+        length = i;
+    }
+
+    return length;
+}
+
+bool Rezonateur::isQuiet(const float *const *outputs, unsigned count) const
+{
+    for (unsigned c = 0; c < fNumChannels; ++c) {
+        const float *output = outputs[c];
+        float peak = 0;
+        for (unsigned i = 0; i < count; ++i) {
+            float a = std::fabs(output[i]);
+            peak = (a > peak) ? a : peak;
+        }
+        if (peak > sSilenceThreshold)
+            return false;
+    }
+
+    return true;
+}
+
+void Rezonateur::flush()
+{
+    // in automatic mode, the ratio stays, and goes down later if the signal
+    // comes back lower
+    cancelAutoFade();
+    fAutoHold = 0;
+
+    fFilterBank.clear();
+    resetOversampler(fOversampling);
+    for (unsigned c = 0; c < fNumChannels; ++c)
+        fAutoPadding[c].clear();
+}
+
+void Rezonateur::processWithRatio(unsigned ratio, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    switch (fOversamplerQuality) {
+    case EconomyQuality:
+        processWithTier(fEconomyOversamplers, ratio, bank, inputs, outputs, count, mix);
+        break;
+    default:
+    case StandardQuality:
+        processWithTier(fStandardOversamplers, ratio, bank, inputs, outputs, count, mix);
+        break;
+    case HighQuality:
+        processWithTier(fHighOversamplers, ratio, bank, inputs, outputs, count, mix);
+        break;
+    }
+}
+
+template <class Tier> void Rezonateur::processWithTier(Tier &tier, unsigned ratio, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    if (fOversamplerType == IIROversamplerType)
+        processWithSet(tier.fIIR, ratio, bank, inputs, outputs, count, mix);
+    else
+        processWithSet(tier.fFIR, ratio, bank, inputs, outputs, count, mix);
+}
+
+template <class Set> void Rezonateur::processWithSet(Set &set, unsigned ratio, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    switch (ratio) {
     default:
         assert(false);
         /* fall through */
-    case 1:
-        DSP::NoOversampler noOversampler;
-        processOversampled(noOversampler, input, output, count);
+    case 1: {
+        DSP::NoOversampler noOversampler[MaximumChannels];
+        processOversampled(noOversampler, bank, inputs, outputs, count, mix);
         break;
+    }
     case 2:
-        processOversampled(fOversampler2x, input, output, count);
+        processOversampled(set.f2x, bank, inputs, outputs, count, mix);
         break;
     case 4:
-        processOversampled(fOversampler4x, input, output, count);
+        processOversampled(set.f4x, bank, inputs, outputs, count, mix);
         break;
     case 8:
-        processOversampled(fOversampler8x, input, output, count);
+        processOversampled(set.f8x, bank, inputs, outputs, count, mix);
+        break;
+    case 16:
+        processOversampled(set.f16x, bank, inputs, outputs, count, mix);
+        break;
+    case 32:
+        processOversampled(set.f32x, bank, inputs, outputs, count, mix);
         break;
     }
 }
 
-template <class Oversampler> void Rezonateur::processOversampled(Oversampler &oversampler, const float *input, float *output, unsigned count)
+void Rezonateur::processAuto(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
 {
+    const unsigned channels = fNumChannels;
+    const unsigned latency = getLatency();
+
+    const float *input[MaximumChannels];
+    float *output[MaximumChannels];
+    float *current[MaximumChannels];
+    float *next[MaximumChannels];
+    for (unsigned c = 0; c < channels; ++c) {
+        input[c] = inputs[c];
+        output[c] = outputs[c];
+        current[c] = getWorkBuffer(2 * fWorkRatio + 1, c);
+        next[c] = getWorkBuffer(2 * fWorkRatio + 2, c);
+    }
+
+    Mix currentMix;
+    if (mix)
+        currentMix = *mix;
+
+    // the next ratio starts cold, it fades in once it is past the latency
+    // of its oversampler and of its padding. The fade ends on the grid of
+    // the control intervals, as it starts.
+    unsigned warmup = latency + 16 + sControlInterval - 1;
+    warmup -= warmup % sControlInterval;
+    unsigned remaining = fIntervalRemaining;
+
     while (count > 0) {
-        unsigned current = (count < sBufferLimit) ? count : sBufferLimit;
-        processWithinBufferLimit(oversampler, input, output, current);
-        input += current;
-        output += current;
+        unsigned n = (count < fBufferLimit) ? count : fBufferLimit;
+        if (fFadeRatio != 0) {
+            unsigned remaining = warmup + sAutoFadeLength - fFadePosition;
+            n = (n < remaining) ? n : remaining;
+        }
+
+        unsigned nextRatio;
+        n = scheduleAuto(input, n, remaining, nextRatio);
+
+        processWithRatio(fOversampling, fFilterBank, input, current, n, nullptr);
+        unsigned padding = latency - getLatency(fOversamplerType, fOversamplerQuality, fOversampling);
+        for (unsigned c = 0; c < channels; ++c) {
+            fAutoPadding[c].write(current[c], n);
+            fAutoPadding[c].read(current[c], n, padding);
+        }
+
+        if (fFadeRatio == 0) {
+            for (unsigned c = 0; c < channels; ++c)
+                std::memcpy(output[c], current[c], n * sizeof(float));
+        }
+        else {
+            processWithRatio(fFadeRatio, fFadeBank, input, next, n, nullptr);
+            unsigned padding = latency - getLatency(fOversamplerType, fOversamplerQuality, fFadeRatio);
+            for (unsigned c = 0; c < channels; ++c) {
+                fFadePadding[c].write(next[c], n);
+                fFadePadding[c].read(next[c], n, padding);
+            }
+
+            const unsigned position = fFadePosition;
+            for (unsigned i = 0; i < n; ++i) {
+                int x = (int)(position + i) - (int)warmup;
+                float mix = (float)x * (1.0f / sAutoFadeLength);
+                mix = (mix < 0.0f) ? 0.0f : mix;
+                mix = (mix > 1.0f) ? 1.0f : mix;
+                for (unsigned c = 0; c < channels; ++c)
+                    output[c][i] = current[c][i] + mix * (next[c][i] - current[c][i]);
+            }
+
+            fFadePosition = position + n;
+            if (fFadePosition == warmup + sAutoFadeLength)
+                finishAutoFade();
+        }
+        if (nextRatio != 0)
+            startAutoFade(nextRatio);
+
+        if (mix) {
+            mixOutputs(output, nullptr, n, &currentMix);
+            currentMix = currentMix.advance(n, channels);
+        }
+
+        for (unsigned c = 0; c < channels; ++c) {
+            input[c] += n;
+            output[c] += n;
+        }
+        count -= n;
+    }
+}
+
+unsigned Rezonateur::scheduleAuto(const float *const *inputs, unsigned count, unsigned &remaining, unsigned &nextRatio)
+{
+    // The ratio is decided at the end of every control interval, from the
+    // peak of its input, so the decisions fall on the same samples whatever
+    // the blocks. The count is cut where a fade has to start.
+    const unsigned channels = fNumChannels;
+    unsigned done = 0;
+    nextRatio = 0;
+
+    while (done < count) {
+        unsigned n = count - done;
+        n = (n < remaining) ? n : remaining;
+
+        float peak = fAutoPeak;
+        for (unsigned c = 0; c < channels; ++c) {
+            const float *input = inputs[c] + done;
+            for (unsigned i = 0; i < n; ++i) {
+                float a = std::fabs(input[i]);
+                peak = (a > peak) ? a : peak;
+            }
+        }
+        done += n;
+
+        if ((remaining -= n) > 0) {
+            fAutoPeak = peak;
+            break;
+        }
+        remaining = sControlInterval;
+        fAutoPeak = 0;
+        if (fFadeRatio != 0)
+            continue;
+
+        // go up at once, go down after the signal stayed low for a while
+        unsigned ratio = estimateOversampling(peak);
+        if (ratio == fOversampling)
+            fAutoHold = 0;
+        else if (ratio > fOversampling || (fAutoHold += sControlInterval) > 0.5 * fSampleRate) {
+            nextRatio = ratio;
+            break;
+        }
+    }
+
+    return done;
+}
+
+unsigned Rezonateur::estimateOversampling(float peak) const
+{
+    // The saturation x - x^3/3 of the filter states makes odd harmonics.
+    // With a state of amplitude A, the 3rd harmonic has the level A^3/12,
+    // and the next ones are estimated to fall by the same factor each,
+    // the hard clip above 1 bounding the factor. The harmonics under the
+    // threshold are ignored, the others must not fold into the audio band,
+    // which is the case below (ratio - 1/2) * samplerate.
+    const double threshold = 1e-4; // -80 dB
+    const double samplerate = fSampleRate;
+
+    // nothing to alias without a nonlinearity
+    if (fFilterBank.getCharacter() == LinearCharacter)
+        return 1;
+
+    float gains[3];
+    getEffectiveFilterGains(gains);
+
+    unsigned ratio = 1;
+    for (unsigned b = 0; b < 3; ++b) {
+        // at resonance, the states gain about Q over the input
+        double q = fFilterQ[b];
+        double level = peak * std::fabs(fInputGain * gains[b]) * ((q > 1.0) ? q : 1.0);
+
+        double factor = level * level * level * (1.0 / 12.0);
+        factor = (factor < 0.5) ? factor : 0.5;
+
+        unsigned order = 1;
+        for (double h = level * factor; h > threshold && order < 63; h *= factor)
+            order += 2;
+
+        double bandwidth = order * fFilterCutoffFreqs[b];
+        while (ratio < MaximumOversampling && (ratio - 0.5) * samplerate < bandwidth)
+            ratio *= 2;
+    }
+
+    return ratio;
+}
+
+void Rezonateur::startAutoFade(unsigned ratio)
+{
+    fFadeRatio = ratio;
+    fFadePosition = 0;
+    fAutoHold = 0;
+
+    // the states carry over, they are close to the band and low-pass
+    // outputs, which do not depend on the rate
+    fFadeBank = fFilterBank;
+    updateFilterBank();
+
+    resetOversampler(ratio);
+    for (unsigned c = 0; c < fNumChannels; ++c)
+        fFadePadding[c].clear();
+}
+
+void Rezonateur::finishAutoFade()
+{
+    unsigned ratio = fFadeRatio;
+
+    fOversampling = ratio;
+    for (unsigned b = 0; b < 3; ++b)
+        fFilters[b].setCutoffFreq(fFilterCutoffFreqs[b] / ratio);
+
+    fFilterBank = fFadeBank;
+    for (unsigned c = 0; c < fNumChannels; ++c)
+        std::swap(fAutoPadding[c], fFadePadding[c]);
+
+    fFadeRatio = 0;
+    updateFilterBank();
+}
+
+void Rezonateur::cancelAutoFade()
+{
+    fFadeRatio = 0;
+}
+
+// the block functions of the oversamplers; at 1x, there are none to call
+template <class Oversampler> static void upsampleBlock(Oversampler &oversampler, const float *in, float *out, unsigned n)
+{
+    oversampler.upsampleBlock(in, out, n);
+}
+
+template <class Oversampler> static void downsampleBlock(Oversampler &oversampler, const float *in, float *out, unsigned n)
+{
+    oversampler.downsampleBlock(in, out, n);
+}
+
+static void upsampleBlock(DSP::NoOversampler &, const float *, float *, unsigned)
+{
+}
+
+static void downsampleBlock(DSP::NoOversampler &, const float *, float *, unsigned)
+{
+}
+
+template <class Oversampler> void Rezonateur::processOversampled(Oversampler *oversamplers, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
+{
+    const unsigned channels = fNumChannels;
+    const unsigned limit = fBufferLimit;
+
+    const float *input[MaximumChannels];
+    float *output[MaximumChannels];
+    for (unsigned c = 0; c < channels; ++c) {
+        input[c] = inputs[c];
+        output[c] = outputs[c];
+    }
+
+    Mix currentMix;
+    if (mix)
+        currentMix = *mix;
+
+    while (count > 0) {
+        unsigned current = (count < limit) ? count : limit;
+        processWithinBufferLimit(oversamplers, bank, input, output, current, mix ? &currentMix : nullptr);
+        for (unsigned c = 0; c < channels; ++c) {
+            input[c] += current;
+            output[c] += current;
+        }
+        if (mix)
+            currentMix = currentMix.advance(current, channels);
         count -= current;
     }
 }
 
-template <class Oversampler> void Rezonateur::processWithinBufferLimit(Oversampler &oversampler, const float *input, float *output, unsigned count)
+template <class Oversampler> void Rezonateur::processWithinBufferLimit(Oversampler *oversamplers, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix)
 {
     constexpr unsigned ratio = Oversampler::Ratio;
+    const unsigned channels = fNumChannels;
+    const bool multirate = ratio > 1 && isLowBandMultirate();
 
-    float filterGains[3];
-    getEffectiveFilterGains(filterGains);
-
-    float *accum = getWorkBuffer(0 * MaximumOversampling);
-    float *filterOutput = getWorkBuffer(1 * MaximumOversampling);
+    const float *filterInputs[MaximumChannels] = {};
+    float *accums[MaximumChannels] = {};
+    float *lowBands[MaximumChannels] = {};
 
     ///
-    if (ratio > 1) {
-        float *filterInput = getWorkBuffer(2 * MaximumOversampling);
-        for (unsigned i = 0; i < count; ++i) {
-            filterInput[i * ratio] = oversampler.upsample(input[i]);
-            for (unsigned o = 1; o < ratio; ++o)
-                filterInput[i * ratio + o] = oversampler.uppad(o);
+    for (unsigned c = 0; c < channels; ++c) {
+        if (ratio > 1) {
+            float *filterInput = getWorkBuffer(1 * fWorkRatio, c);
+            upsampleBlock(oversamplers[c], inputs[c], filterInput, count);
+            filterInputs[c] = filterInput;
+            accums[c] = getWorkBuffer(0 * fWorkRatio, c);
+            lowBands[c] = getWorkBuffer(2 * fWorkRatio, c);
+        }
+        else {
+            filterInputs[c] = inputs[c];
+            accums[c] = outputs[c];
         }
-        input = filterInput;
     }
 
     ///
-    fFilters[0].process(filterGains[0], input, accum, count * ratio);
-    for (unsigned b = 1; b < 3; ++b) {
-        fFilters[b].process(filterGains[b], input, filterOutput, count * ratio);
-        for (unsigned i = 0; i < count * ratio; ++i)
-            accum[i] += filterOutput[i];
+    if (!multirate)
+        bank.process(filterInputs, accums, count * ratio);
+    else {
+        // the low band at the base rate, delayed as the oversampled bands
+        unsigned latency = getLatency();
+        bank.processMultirate(inputs, lowBands, filterInputs, accums, count, ratio);
+        for (unsigned c = 0; c < channels; ++c) {
+            fLowBandDelay[c].write(lowBands[c], count);
+            fLowBandDelay[c].read(lowBands[c], count, latency);
+        }
     }
 
     ///
-    for (unsigned i = 0; i < count; ++i) {
-        output[i] = oversampler.downsample(accum[i * ratio]);
-        for (unsigned o = 1; o < ratio; ++o)
-            oversampler.downstore(accum[i * ratio + o]);
+    if (ratio > 1) {
+        for (unsigned c = 0; c < channels; ++c)
+            downsampleBlock(oversamplers[c], accums[c], outputs[c], count);
+    }
+
+    // the block is still in cache, one pass finishes it
+    mixOutputs(outputs, multirate ? lowBands : nullptr, count, mix);
+}
+
+void Rezonateur::mixOutputs(float *const *outputs, const float *const *lowBands, unsigned count, const Mix *mix) const
+{
+    const unsigned channels = fNumChannels;
+
+    for (unsigned c = 0; c < channels; ++c) {
+        float *output = outputs[c];
+        const float *lowBand = lowBands ? lowBands[c] : nullptr;
+
+        if (mix) {
+            const float *dryInput = mix->inputs[c];
+            const float dry = mix->dry;
+            const float wet = mix->wet;
+            if (lowBand) {
+                for (unsigned i = 0; i < count; ++i)
+                    output[i] = wet * (output[i] + lowBand[i]) + dry * dryInput[i];
+            }
+            else {
+                for (unsigned i = 0; i < count; ++i)
+                    output[i] = wet * output[i] + dry * dryInput[i];
+            }
+        }
+        else if (lowBand) {
+            for (unsigned i = 0; i < count; ++i)
+                output[i] += lowBand[i];
+        }
     }
 }
 
@@ -204,6 +1168,44 @@ void Rezonateur::getEffectiveFilterGains(float gains[3]) const
     gains[2] = fFilterGains[2];
 }
 
+static void setBankBand(SVFBank &bank, unsigned nth, const VAStateVariableFilter &filter, float gain, bool ramp)
+{
+    if (ramp)
+        bank.rampBand(nth, filter, gain);
+    else
+        bank.setBand(nth, filter, gain);
+}
+
+void Rezonateur::updateFilterBank(unsigned bands, bool ramp)
+{
+    float filterGains[3];
+    getEffectiveFilterGains(filterGains);
+    for (unsigned b = 0; b < 3; ++b)
+        filterGains[b] *= fInputGain;
+
+    for (unsigned b = 0; b < 3; ++b) {
+        if (bands & (1u << b))
+            setBankBand(fFilterBank, b, fFilters[b], filterGains[b], ramp);
+    }
+
+    if ((bands & 1) && isLowBandMultirate()) {
+        VAStateVariableFilter lowBand = fFilters[0];
+        lowBand.setCutoffFreq(fFilterCutoffFreqs[0]);
+        setBankBand(fFilterBank, 0, lowBand, filterGains[0], ramp);
+    }
+
+    if (fFadeRatio != 0) {
+        fFadeBank.setFilterType(getFilterTypeForMode(fMode));
+        for (unsigned b = 0; b < 3; ++b) {
+            if (bands & (1u << b)) {
+                VAStateVariableFilter filter = fFilters[b];
+                filter.setCutoffFreq(fFilterCutoffFreqs[b] / fFadeRatio);
+                setBankBand(fFadeBank, b, filter, filterGains[b], ramp);
+            }
+        }
+    }
+}
+
 int Rezonateur::getFilterTypeForMode(int mode)
 {
     switch (mode) {
@@ -234,16 +1236,246 @@ double Rezonateur::getResponseGain(double f) const
     return std::abs(h);
 }
 
-void Rezonateur::allocateWorkBuffers(unsigned count)
+template <template <unsigned, int> class Oversampler, int Quality>
+std::size_t Rezonateur::OversamplerSet<Oversampler, Quality>::getSize(unsigned ratio, unsigned channels)
 {
-    fWorkBuffers.reset(new float[count * sBufferLimit]);
-    fNumWorkBuffers = count;
+    bool all = ratio == AutoOversampling;
+    std::size_t size = 0;
+    if (all || ratio == 2)
+        size += Arena::getSize<Oversampler<2, Quality>>(channels);
+    if (all || ratio == 4)
+        size += Arena::getSize<Oversampler<4, Quality>>(channels);
+    if (all || ratio == 8)
+        size += Arena::getSize<Oversampler<8, Quality>>(channels);
+    if (all || ratio == 16)
+        size += Arena::getSize<Oversampler<16, Quality>>(channels);
+    if (all || ratio == 32)
+        size += Arena::getSize<Oversampler<32, Quality>>(channels);
+    return size;
+}
+
+template <template <unsigned, int> class Oversampler, int Quality>
+bool Rezonateur::OversamplerSet<Oversampler, Quality>::place(Arena &arena, unsigned ratio, unsigned channels)
+{
+    bool all = ratio == AutoOversampling;
+    bool placed = true;
+    if (all || ratio == 2)
+        placed = placed && (f2x = arena.construct<Oversampler<2, Quality>>(channels));
+    if (all || ratio == 4)
+        placed = placed && (f4x = arena.construct<Oversampler<4, Quality>>(channels));
+    if (all || ratio == 8)
+        placed = placed && (f8x = arena.construct<Oversampler<8, Quality>>(channels));
+    if (all || ratio == 16)
+        placed = placed && (f16x = arena.construct<Oversampler<16, Quality>>(channels));
+    if (all || ratio == 32)
+        placed = placed && (f32x = arena.construct<Oversampler<32, Quality>>(channels));
+    return placed;
+}
+
+template <template <unsigned, int> class Oversampler, int Quality>
+void Rezonateur::OversamplerSet<Oversampler, Quality>::release()
+{
+    f2x = nullptr;
+    f4x = nullptr;
+    f8x = nullptr;
+    f16x = nullptr;
+    f32x = nullptr;
+}
+
+template <template <unsigned, int> class Oversampler, int Quality>
+void Rezonateur::OversamplerSet<Oversampler, Quality>::reset(unsigned ratio, unsigned channels)
+{
+    for (unsigned c = 0; c < channels; ++c) {
+        switch (ratio) {
+        case 2:
+            f2x[c].reset();
+            break;
+        case 4:
+            f4x[c].reset();
+            break;
+        case 8:
+            f8x[c].reset();
+            break;
+        case 16:
+            f16x[c].reset();
+            break;
+        case 32:
+            f32x[c].reset();
+            break;
+        }
+    }
+}
+
+// the latency is that of the design, measured once on a temporary
+template <class Oversampler> static unsigned getDesignLatency()
+{
+    static const unsigned latency = Oversampler().getLatency();
+    return latency;
+}
+
+template <template <unsigned, int> class Oversampler, int Quality>
+unsigned Rezonateur::OversamplerSet<Oversampler, Quality>::getLatency(unsigned ratio)
+{
+    switch (ratio) {
+    default:
+        return 0;
+    case 2:
+        return getDesignLatency<Oversampler<2, Quality>>();
+    case 4:
+        return getDesignLatency<Oversampler<4, Quality>>();
+    case 8:
+        return getDesignLatency<Oversampler<8, Quality>>();
+    case 16:
+        return getDesignLatency<Oversampler<16, Quality>>();
+    case 32:
+        return getDesignLatency<Oversampler<32, Quality>>();
+    }
+}
+
+bool Rezonateur::setupArena()
+{
+    unsigned ratio = getOversampling();
+    if (fArenaType == fOversamplerType && fArenaQuality == fOversamplerQuality && fArenaRatio == ratio)
+        return false;
+
+    fEconomyOversamplers.release();
+    fStandardOversamplers.release();
+    fHighOversamplers.release();
+
+    bool iir = fOversamplerType == IIROversamplerType;
+    bool placed;
+
+    switch (fOversamplerQuality) {
+    case EconomyQuality:
+        if (iir)
+            placed = placeOversamplers(fEconomyOversamplers.fIIR, ratio);
+        else
+            placed = placeOversamplers(fEconomyOversamplers.fFIR, ratio);
+        break;
+    default:
+    case StandardQuality:
+        if (iir)
+            placed = placeOversamplers(fStandardOversamplers.fIIR, ratio);
+        else
+            placed = placeOversamplers(fStandardOversamplers.fFIR, ratio);
+        break;
+    case HighQuality:
+        if (iir)
+            placed = placeOversamplers(fHighOversamplers.fIIR, ratio);
+        else
+            placed = placeOversamplers(fHighOversamplers.fFIR, ratio);
+        break;
+    }
+
+    // the reserve covers every setting, this is not expected to fail
+    assert(placed);
+    if (!placed) {
+        fEconomyOversamplers.release();
+        fStandardOversamplers.release();
+        fHighOversamplers.release();
+        fWorkBuffers = nullptr;
+    }
+    fArenaPlaced = placed;
+
+    fArenaType = fOversamplerType;
+    fArenaQuality = fOversamplerQuality;
+    fArenaRatio = ratio;
+    return true;
+}
+
+template <class Set> bool Rezonateur::placeOversamplers(Set &set, unsigned ratio)
+{
+    const unsigned channels = fNumChannels;
+    unsigned workRatio = getWorkRatio(ratio);
+    unsigned numWorkBuffers = getNumWorkBuffers(ratio);
+    unsigned limit = getBufferLimit(workRatio);
+
+    fArena.clear();
+    fWorkBuffers = fArena.construct<float>(numWorkBuffers * limit);
+    fNumWorkBuffers = numWorkBuffers;
+    fWorkRatio = workRatio;
+    fBufferLimit = limit;
+    if (!fWorkBuffers && numWorkBuffers > 0)
+        return false;
+    return set.place(fArena, ratio, channels);
+}
+
+std::size_t Rezonateur::getArenaSize(int type, int quality, unsigned ratio) const
+{
+    const unsigned channels = fNumChannels;
+    bool iir = type == IIROversamplerType;
+    std::size_t size = getWorkSize(ratio);
+
+    switch (quality) {
+    case EconomyQuality:
+        return size + (iir ? fEconomyOversamplers.fIIR.getSize(ratio, channels) :
+            fEconomyOversamplers.fFIR.getSize(ratio, channels));
+    default:
+    case StandardQuality:
+        return size + (iir ? fStandardOversamplers.fIIR.getSize(ratio, channels) :
+            fStandardOversamplers.fFIR.getSize(ratio, channels));
+    case HighQuality:
+        return size + (iir ? fHighOversamplers.fIIR.getSize(ratio, channels) :
+            fHighOversamplers.fFIR.getSize(ratio, channels));
+    }
+}
+
+std::size_t Rezonateur::getMaximumArenaSize() const
+{
+    std::size_t size = 0;
+    for (int type : {FIROversamplerType, IIROversamplerType}) {
+        for (int quality : {EconomyQuality, StandardQuality, HighQuality}) {
+            for (unsigned ratio : {1u, 2u, 4u, 8u, 16u, 32u, (unsigned)AutoOversampling}) {
+                std::size_t current = getArenaSize(type, quality, ratio);
+                size = (current > size) ? current : size;
+            }
+        }
+    }
+    return size;
+}
+
+std::size_t Rezonateur::getWorkSize(unsigned ratio) const
+{
+    unsigned limit = getBufferLimit(getWorkRatio(ratio));
+    return Arena::getSize<float>(getNumWorkBuffers(ratio) * limit);
+}
+
+unsigned Rezonateur::getWorkRatio(unsigned ratio)
+{
+    return (ratio == AutoOversampling) ? (unsigned)MaximumOversampling : ratio;
+}
+
+unsigned Rezonateur::getNumWorkBuffers(unsigned ratio) const
+{
+    // the base rate is processed in place
+    return (ratio != 1) ? (2 * getWorkRatio(ratio) + 3) * fNumChannels : 0;
+}
+
+unsigned Rezonateur::getBufferLimit(unsigned workRatio) const
+{
+    // a whole number of control intervals, at least one
+    unsigned frameSize = (2 * workRatio + 3) * fNumChannels * sizeof(float);
+    unsigned limit = sCacheBudget / frameSize;
+    unsigned block = fMaximumBlockSize + sControlInterval - 1;
+    limit = (limit < block) ? limit : block;
+    limit -= limit % sControlInterval;
+    return (limit > sControlInterval) ? limit : sControlInterval;
 }
 
 float *Rezonateur::getWorkBuffer(unsigned index)
 {
     assert(index < fNumWorkBuffers);
-    return &fWorkBuffers[index * sBufferLimit];
+    return &fWorkBuffers[index * fBufferLimit];
+}
+
+float *Rezonateur::getWorkBuffer(unsigned index, unsigned channel)
+{
+    assert(channel < fNumChannels);
+    return getWorkBuffer(index + channel * (fNumWorkBuffers / fNumChannels));
 }
 
-constexpr unsigned Rezonateur::sBufferLimit;
+constexpr unsigned Rezonateur::sDefaultBlockSize;
+constexpr unsigned Rezonateur::sCacheBudget;
+constexpr float Rezonateur::sSilenceThreshold;
+constexpr unsigned Rezonateur::sControlInterval;
+constexpr double Rezonateur::sSmoothingTime;
@@ -1,26 +1,62 @@
 #pragma once
+#include "SVFBank.h"
 #include "svf/VAStateVariableFilter.h"
 #include "dsp/Oversampler.h"
+#include "dsp/FIROversampler.h"
+#include "dsp/IIROversampler.h"
+#include "dsp/DelayLine.h"
+#include "dsp/Arena.h"
 #include <complex>
-#include <memory>
 
 class Rezonateur {
 public:
-    void init(double samplerate);
+    void init(double samplerate, unsigned channels = 1);
+    unsigned getNumChannels() const;
 
     void setFilterMode(int mode);
     void setFilterGain(unsigned nth, float gain);
     void setFilterCutoff(unsigned nth, float cutoff);
     void setFilterEmph(unsigned nth, float emph);
+    void setBand(unsigned nth, float gain, float cutoff, float emph);
+    // the gain at the input of all bands, smoothed as the band gains
+    void setInputGain(float gain);
+    float getInputGain() const;
     int getFilterMode() const;
     float getFilterGain(unsigned nth) const;
     float getFilterCutoff(unsigned nth) const;
     float getFilterEmph(unsigned nth) const;
 
+    // AutoOversampling picks the ratio per block, from the signal level
+    // and the filter settings
+    enum { AutoOversampling = 0 };
     unsigned getOversampling() const;
     void setOversampling(unsigned oversampling);
+    int getOversamplerType() const;
+    void setOversamplerType(int type);
+    int getOversamplerQuality() const;
+    void setOversamplerQuality(int quality);
+    int getFilterPrecision() const;
+    void setFilterPrecision(int precision);
+    int getFilterCharacter() const;
+    void setFilterCharacter(int character);
+
+    // the largest block of the host, the memory is laid out for it; as
+    // init, this is not to be called during the processing
+    void setMaximumBlockSize(unsigned size);
+
+    // latency in samples, for the current and for any setting
+    unsigned getLatency() const;
+    unsigned getMaximumLatency() const;
 
     void process(const float *input, float *output, unsigned count);
+    void process(const float *const *inputs, float *const *outputs, unsigned count);
+    // the output mixes the filters, at the wet gain, with the dry inputs,
+    // which the caller delays to the latency
+    void process(const float *const *inputs, float *const *outputs, unsigned count, const float *const *dryInputs, float dry, float wet);
+
+    // the band settings are staged, and the bands which changed follow them
+    // smoothly in the next process, or reach them at once here
+    void updateCoefficients();
 
     double getResponseGain(double f) const;
 
@@ -31,32 +67,194 @@ public:
         BandpassNotchMode,
     };
 
+    enum OversamplerType {
+        FIROversamplerType,
+        IIROversamplerType,
+    };
+
+    enum OversamplerQuality {
+        EconomyQuality = HalfbandEconomy,
+        StandardQuality = HalfbandStandard,
+        HighQuality = HalfbandHigh,
+    };
+
+    // the default is single precision if REZONATEUR_SINGLE_PRECISION is set
+    enum FilterPrecision {
+        DoublePrecision = SVFBank::DoublePrecision,
+        SinglePrecision = SVFBank::SinglePrecision,
+    };
+
+    enum FilterCharacter {
+        LinearCharacter = SVFBank::LinearCharacter,
+        SaturatingCharacter = SVFBank::SaturatingCharacter,
+        ImplicitCharacter = SVFBank::ImplicitCharacter,
+        AntialiasedCharacter = SVFBank::AntialiasedCharacter,
+    };
+
 private:
-    template <class Oversampler> void processOversampled(Oversampler &oversampler, const float *input, float *output, unsigned count);
-    template <class Oversampler> void processWithinBufferLimit(Oversampler &oversampler, const float *input, float *output, unsigned count);
+    enum { MaximumChannels = SVFBank::MaximumChannels };
+
+    // the dry signal and the gains, applied in the last pass over the output
+    struct Mix {
+        const float *inputs[MaximumChannels];
+        float dry;
+        float wet;
+        Mix advance(unsigned count, unsigned channels) const;
+    };
+
+    void processMixed(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    unsigned processIdle(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    unsigned processActive(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    void processFiltered(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    void processWithRatio(unsigned ratio, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    template <class Tier> void processWithTier(Tier &tier, unsigned ratio, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    template <class Set> void processWithSet(Set &set, unsigned ratio, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    template <class Oversampler> void processOversampled(Oversampler *oversamplers, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    template <class Oversampler> void processWithinBufferLimit(Oversampler *oversamplers, SVFBank &bank, const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    void processAuto(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    void processBlock(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    void processSmoothly(const float *const *inputs, float *const *outputs, unsigned count, const Mix *mix);
+    void mixOutputs(float *const *outputs, const float *const *lowBands, unsigned count, const Mix *mix) const;
+    void advanceSmoothing();
+    void skipSmoothing(unsigned count);
+    void advanceInterval(unsigned count);
     void getEffectiveFilterGains(float gains[3]) const;
+    void updateFilterBank(unsigned bands = AllBands, bool ramp = false);
+    bool isLowBandMultirate() const;
+    void resetOversampler(unsigned ratio);
+    unsigned getLatency(int type, int quality, unsigned ratio) const;
     static int getFilterTypeForMode(int mode);
 
+    unsigned scheduleAuto(const float *const *inputs, unsigned count, unsigned &remaining, unsigned &nextRatio);
+    unsigned estimateOversampling(float peak) const;
+    void startAutoFade(unsigned ratio);
+    void finishAutoFade();
+    void cancelAutoFade();
+
+    unsigned getSilentLength(const float *const *inputs, unsigned count) const;
+    unsigned getSilentTail(const float *const *inputs, unsigned count) const;
+    bool isQuiet(const float *const *outputs, unsigned count) const;
+    void flush();
+
 private:
+    unsigned fNumChannels = 0;
+    double fSampleRate = 0;
+
     int fMode;
+    // the settings of the filters, which follow the targets
     float fFilterGains[3];
     float fFilterCutoffFreqs[3];
     float fFilterQ[3];
+    float fTargetGains[3];
+    float fTargetCutoffFreqs[3];
+    float fTargetQ[3];
+    float fInputGain = 1;
+    float fTargetInputGain = 1;
     VAStateVariableFilter fFilters[3];
+    SVFBank fFilterBank;
+    enum { AllBands = (1u << 3) - 1 };
+    unsigned fDirtyBands = 0;
+
+    // smoothing: the coefficients are computed at the start of a control
+    // interval, and the bank moves linearly between them. The intervals
+    // follow each other from the start of the stream, and the decisions
+    // which must not depend on the blocks fall on them.
+    double fSmoothing = 0;
+    unsigned fIntervalRemaining = sControlInterval;
+    bool fIntervalRamping = false;
+    static constexpr unsigned sControlInterval = 32;
+    static constexpr double sSmoothingTime = 20e-3;
 
     unsigned fOversampling;
+    int fOversamplerType;
 
-    DSP::Oversampler<2, 32> fOversampler2x;
-    DSP::Oversampler<4, 64> fOversampler4x;
-    DSP::Oversampler<8, 64> fOversampler8x;
-    enum { MaximumOversampling = 8 };
+    int fOversamplerQuality;
+
+    // oversamplers of one type, for every ratio, one per channel; they are
+    // placed in the arena for the ratio in use, AutoOversampling for all
+    template <template <unsigned, int> class Oversampler, int Quality>
+    struct OversamplerSet {
+        static std::size_t getSize(unsigned ratio, unsigned channels);
+        bool place(Arena &arena, unsigned ratio, unsigned channels);
+        void release();
+        void reset(unsigned ratio, unsigned channels);
+        static unsigned getLatency(unsigned ratio);
+        Oversampler<2, Quality> *f2x = nullptr;
+        Oversampler<4, Quality> *f4x = nullptr;
+        Oversampler<8, Quality> *f8x = nullptr;
+        Oversampler<16, Quality> *f16x = nullptr;
+        Oversampler<32, Quality> *f32x = nullptr;
+    };
+
+    // oversamplers of every type, for a quality tier
+    template <int Quality>
+    struct OversamplerTier {
+        OversamplerSet<FIROversampler, Quality> fFIR;
+        OversamplerSet<IIROversampler, Quality> fIIR;
+        void release() { fFIR.release(); fIIR.release(); }
+    };
+
+    OversamplerTier<HalfbandEconomy> fEconomyOversamplers;
+    OversamplerTier<HalfbandStandard> fStandardOversamplers;
+    OversamplerTier<HalfbandHigh> fHighOversamplers;
+    enum { MaximumOversampling = 32 };
+
+    DelayLine fLowBandDelay[MaximumChannels];
+
+    // automatic oversampling: the active ratio is fOversampling, and on a
+    // change, the next ratio runs with its own bank and fades in
+    bool fAutoOversampling = false;
+    unsigned fAutoHold = 0;
+    float fAutoPeak = 0;
+    unsigned fFadeRatio = 0;
+    unsigned fFadePosition = 0;
+    SVFBank fFadeBank;
+    // the ratios are delayed to the same latency, so they can be crossfaded
+    DelayLine fAutoPadding[MaximumChannels];
+    DelayLine fFadePadding[MaximumChannels];
+    static constexpr unsigned sAutoFadeLength = 256;
+
+    // silence: once the input is silent and the tail has decayed on every
+    // channel, the states are flushed and the processing stops, until the
+    // input comes back. The tail is checked by control intervals, and the
+    // quiet ones are counted.
+    bool fIdle = false;
+    bool fIntervalQuiet = true;
+    unsigned fQuietLength = 0;
+    static constexpr float sSilenceThreshold = 1e-8f; // -160 dB
 
 private:
-    void allocateWorkBuffers(unsigned count);
+    bool setupArena();
+    template <class Set> bool placeOversamplers(Set &set, unsigned ratio);
+    std::size_t getArenaSize(int type, int quality, unsigned ratio) const;
+    std::size_t getMaximumArenaSize() const;
+    std::size_t getWorkSize(unsigned ratio) const;
+    static unsigned getWorkRatio(unsigned ratio);
+    unsigned getNumWorkBuffers(unsigned ratio) const;
+    unsigned getBufferLimit(unsigned workRatio) const;
+    void resizeDelays();
     float *getWorkBuffer(unsigned index);
+    float *getWorkBuffer(unsigned index, unsigned channel);
 
 private:
+    // the arena holds the state of the active setting only: the work
+    // buffers, and the oversamplers of the type, quality and ratio in use.
+    // It is reserved for the largest setting by init and by the block size,
+    // and the objects are placed again when one of them changes.
+    Arena fArena;
+    bool fArenaPlaced = false;
+    int fArenaType = -1;
+    int fArenaQuality = -1;
+    unsigned fArenaRatio = 0;
+
+    // the work buffers are sized for the highest ratio of the setting, and
+    // hold chunks which fit in a share of the L2 cache, and do not exceed
+    // the block of the host
+    unsigned fWorkRatio = 0;
     unsigned fNumWorkBuffers = 0;
-    std::unique_ptr<float[]> fWorkBuffers;
-    static constexpr unsigned sBufferLimit = 256;
+    float *fWorkBuffers = nullptr;
+    unsigned fBufferLimit = 0;
+    unsigned fMaximumBlockSize = sDefaultBlockSize;
+    static constexpr unsigned sDefaultBlockSize = 4096;
+    static constexpr unsigned sCacheBudget = 64 * 1024;
 };
@@ -0,0 +1,799 @@
+#include "SVFBank.h"
+#include <cmath>
+#include <cassert>
+
+#if __cplusplus >= 201703L
+# define if_constexpr if constexpr
+#else
+# define if_constexpr if
+#endif
+
+SVFBank::SVFBank()
+    : fNumChannels(1), fFilterType(SVFLowpass)
+{
+    for (unsigned l = 0; l < NumLanes; ++l) {
+        fCoefs.gain[l] = 0.0;
+        fCoefs.g[l] = 1.0;
+        fCoefs.r2[l] = 2.0;
+        fCoefs.k[l] = 0.0;
+        fCoefs.denom[l] = 1.0 / 4.0;
+    }
+    fRampCoefs = fCoefs;
+    fTargetCoefs = fCoefs;
+
+    clear();
+}
+
+void SVFBank::setNumChannels(unsigned channels)
+{
+    assert(channels > 0 && channels <= MaximumChannels);
+    fNumChannels = channels;
+    clear();
+}
+
+void SVFBank::setFilterType(int type)
+{
+    fFilterType = type;
+    fLinearBlockValid = false;
+}
+
+void SVFBank::setPrecision(int precision)
+{
+    fPrecision = precision;
+}
+
+int SVFBank::getPrecision() const
+{
+    return fPrecision;
+}
+
+void SVFBank::setCharacter(int character)
+{
+    fCharacter = character;
+}
+
+int SVFBank::getCharacter() const
+{
+    return fCharacter;
+}
+
+void SVFBank::setBand(unsigned nth, const VAStateVariableFilter &filter, float gain)
+{
+    rampBand(nth, filter, gain);
+
+    const Coefficients &target = fTargetCoefs;
+    for (Coefficients *coefs : {&fCoefs, &fRampCoefs}) {
+        coefs->gain[nth] = target.gain[nth];
+        coefs->g[nth] = target.g[nth];
+        coefs->r2[nth] = target.r2[nth];
+        coefs->k[nth] = target.k[nth];
+        coefs->denom[nth] = target.denom[nth];
+    }
+    fLinearBlockValid = false;
+}
+
+void SVFBank::rampBand(unsigned nth, const VAStateVariableFilter &filter, float gain)
+{
+    assert(nth < NumBands);
+
+    double g = filter.getGCoeff();
+    double r2 = 2.0 * filter.getRCoeff();
+
+    Coefficients &target = fTargetCoefs;
+    target.gain[nth] = gain;
+    target.g[nth] = g;
+    target.r2[nth] = r2;
+    target.k[nth] = filter.getShelfGain();
+    target.denom[nth] = 1.0 / (1.0 + r2 * g + g * g);
+
+    // the ramp starts from where the coefficients are
+    fRampCoefs = fCoefs;
+    fRampBegin = 0;
+    fRampEnd = 1;
+    fRampLength = 1;
+    fRamping = true;
+}
+
+void SVFBank::setRampSpan(unsigned begin, unsigned end, unsigned length)
+{
+    assert(begin < end && end <= length);
+    fRampBegin = begin;
+    fRampEnd = end;
+    fRampLength = length;
+}
+
+void SVFBank::skipRamp()
+{
+    advanceRamp();
+}
+
+void SVFBank::finishRamp()
+{
+    fCoefs = fTargetCoefs;
+    fRampCoefs = fTargetCoefs;
+    fRamping = false;
+    fRampBegin = 0;
+    fRampEnd = 1;
+    fRampLength = 1;
+    fLinearBlockValid = false;
+}
+
+void SVFBank::advanceRamp()
+{
+    if (!fRamping)
+        return;
+    if (fRampEnd >= fRampLength) {
+        finishRamp();
+        return;
+    }
+
+    // where the lanes are at the end of the span
+    const double t = (double)fRampEnd / fRampLength;
+    Coefficients &coefs = fCoefs;
+    const Coefficients &start = fRampCoefs;
+    const Coefficients &target = fTargetCoefs;
+    for (unsigned l = 0; l < NumLanes; ++l) {
+        coefs.gain[l] = start.gain[l] + t * (target.gain[l] - start.gain[l]);
+        coefs.g[l] = start.g[l] + t * (target.g[l] - start.g[l]);
+        coefs.r2[l] = start.r2[l] + t * (target.r2[l] - start.r2[l]);
+        coefs.k[l] = start.k[l] + t * (target.k[l] - start.k[l]);
+        coefs.denom[l] = start.denom[l] + t * (target.denom[l] - start.denom[l]);
+    }
+    fRampBegin = fRampEnd;
+    fLinearBlockValid = false;
+}
+
+void SVFBank::updateLinearBlock()
+{
+    const unsigned L = LinearBlockLength;
+    LinearBlock &lb = fLinearBlock;
+
+    for (unsigned l = 0; l < NumLanes; ++l) {
+        double gain = fCoefs.gain[l];
+        double g = fCoefs.g[l];
+        double r2 = fCoefs.r2[l];
+        double k = fCoefs.k[l];
+        double denom = fCoefs.denom[l];
+
+        // the signals of a step, as rows of factors of (z1, z2, x)
+        double HP[3] = {-(r2 + g) * denom, -denom, gain * denom};
+        double BP[3] = {g * HP[0] + 1, g * HP[1], g * HP[2]};
+        double LP[3] = {g * BP[0], g * BP[1] + 1, g * BP[2]};
+        double in[3] = {0, 0, gain};
+
+        double out[3];
+        for (unsigned i = 0; i < 3; ++i) {
+            switch (fFilterType) {
+            default:
+            case SVFLowpass: out[i] = LP[i]; break;
+            case SVFBandpass: out[i] = BP[i]; break;
+            case SVFHighpass: out[i] = HP[i]; break;
+            case SVFUnitGainBandpass: out[i] = r2 * BP[i]; break;
+            case SVFBandShelving: out[i] = in[i] + r2 * k * BP[i]; break;
+            case SVFNotch: out[i] = in[i] - r2 * BP[i]; break;
+            case SVFAllpass: out[i] = in[i] - 2 * r2 * BP[i]; break;
+            case SVFPeak: out[i] = LP[i] - HP[i]; break;
+            }
+        }
+
+        // the state transition z = A z + B x, and the output y = C z + D x
+        double A[2][2] = {{2 * BP[0] - 1, 2 * BP[1]}, {2 * LP[0], 2 * LP[1] - 1}};
+        double B[2] = {2 * BP[2], 2 * LP[2]};
+        double C[2] = {out[0], out[1]};
+
+        // output of the states and of the inputs, with C A^i
+        lb.impulse[l][0] = out[2];
+        for (unsigned i = 0; i < L; ++i) {
+            lb.observe[l][0][i] = C[0];
+            lb.observe[l][1][i] = C[1];
+            if (i + 1 < L)
+                lb.impulse[l][i + 1] = C[0] * B[0] + C[1] * B[1];
+            double C0 = C[0] * A[0][0] + C[1] * A[1][0];
+            double C1 = C[0] * A[0][1] + C[1] * A[1][1];
+            C[0] = C0;
+            C[1] = C1;
+        }
+
+        // contributions of the inputs to the next state, with A^i B
+        for (unsigned i = 0; i < L; ++i) {
+            lb.control[l][0][L - 1 - i] = B[0];
+            lb.control[l][1][L - 1 - i] = B[1];
+            double B0 = A[0][0] * B[0] + A[0][1] * B[1];
+            double B1 = A[1][0] * B[0] + A[1][1] * B[1];
+            B[0] = B0;
+            B[1] = B1;
+        }
+
+        // the transition over a block, with A^L
+        double P[2][2] = {{1, 0}, {0, 1}};
+        for (unsigned i = 0; i < L; ++i) {
+            double P00 = P[0][0] * A[0][0] + P[0][1] * A[1][0];
+            double P01 = P[0][0] * A[0][1] + P[0][1] * A[1][1];
+            double P10 = P[1][0] * A[0][0] + P[1][1] * A[1][0];
+            double P11 = P[1][0] * A[0][1] + P[1][1] * A[1][1];
+            P[0][0] = P00;
+            P[0][1] = P01;
+            P[1][0] = P10;
+            P[1][1] = P11;
+        }
+        for (unsigned i = 0; i < 2; ++i) {
+            for (unsigned j = 0; j < 2; ++j)
+                lb.transition[l][i][j] = P[i][j];
+        }
+    }
+
+    fLinearBlockValid = true;
+}
+
+void SVFBank::clear()
+{
+    for (unsigned c = 0; c < MaximumChannels; ++c) {
+        ChannelState &state = fStates[c];
+        for (unsigned l = 0; l < NumLanes; ++l) {
+            state.z1[l] = 0.0;
+            state.z2[l] = 0.0;
+            state.v1[l] = 0.0;
+            state.v2[l] = 0.0;
+        }
+    }
+}
+
+double SVFBank::getStateMagnitude(unsigned channel) const
+{
+    assert(channel < fNumChannels);
+
+    const ChannelState &state = fStates[channel];
+    double mag = 0.0;
+    for (unsigned l = 0; l < NumLanes; ++l) {
+        double z1 = std::fabs(state.z1[l]);
+        double z2 = std::fabs(state.z2[l]);
+        mag = (z1 > mag) ? z1 : mag;
+        mag = (z2 > mag) ? z2 : mag;
+    }
+    return mag;
+}
+
+template <class T>
+static inline T analogSaturate(T x)
+{
+    // branchless form of the saturation in VAStateVariableFilter
+    x = (x < T(-1)) ? T(-1) : x;
+    x = (x > T(+1)) ? T(+1) : x;
+    return x - (x * x * x) * T(1.0 / 3.0);
+}
+
+template <class T>
+static inline T analogSaturateSlope(T x)
+{
+    x = (x < T(-1)) ? T(-1) : x;
+    x = (x > T(+1)) ? T(+1) : x;
+    return T(1) - x * x;
+}
+
+// the antiderivative of the residue x - f(x) of the saturation
+template <class T>
+static inline T analogSaturateResidueIntegral(T x)
+{
+    T ax = (x < T(0)) ? -x : x;
+    return (ax > T(1)) ? (T(0.5) * x * x - T(2.0 / 3.0) * ax + T(0.25)) : (x * x * x * x * T(1.0 / 12.0));
+}
+
+template <class T>
+static inline T analogSaturateAntialiased(T x, T x1, T &r1)
+{
+    // First-order antiderivative antialiasing of the saturation, over the
+    // segment from the last input x1 to the input x. Only the residue
+    // x - f(x) is antialiased, so the linear path keeps no half-sample
+    // delay, and the filter keeps its tuning at small levels.
+    // Within [-1, 1], the residue x^3/3 has the antiderivative x^4/12,
+    // of which the difference quotient is a polynomial.
+    T inner = (x + x1) * (x * x + x1 * x1) * T(1.0 / 12.0);
+
+    // Outside, the residue x - 2/3 sgn(x) has the antiderivative
+    // x^2/2 - 2/3 |x| + 1/4. Close inputs take the residue of the midpoint.
+    T ax = (x < T(0)) ? -x : x;
+    T ax1 = (x1 < T(0)) ? -x1 : x1;
+    T r = analogSaturateResidueIntegral(x);
+    T dx = x - x1;
+    const T tolerance = (sizeof(T) > 4) ? T(1e-6) : T(1e-3);
+    bool close = dx < tolerance && dx > -tolerance;
+    T mid = T(0.5) * (x + x1);
+    T outer = close ? (mid - analogSaturate(mid)) : ((r - r1) / (close ? T(1) : dx));
+
+    T residue = (ax > T(1) || ax1 > T(1)) ? outer : inner;
+    r1 = r;
+    return x - residue;
+}
+
+// a range of bands, copied in locals for the duration of a block,
+// and computed in the precision T
+template <class T, unsigned Lanes>
+struct SVFBank::LaneBlock {
+    alignas(32) T gain[Lanes], g[Lanes], r2[Lanes], k[Lanes], denom[Lanes];
+    alignas(32) T z1[MaximumChannels][Lanes], z2[MaximumChannels][Lanes];
+    // last inputs of the state saturators, and their antiderivatives
+    alignas(32) T v1[MaximumChannels][Lanes], v2[MaximumChannels][Lanes];
+    alignas(32) T a1[MaximumChannels][Lanes], a2[MaximumChannels][Lanes];
+    // when ramping, the coefficients at the start, their differences to the
+    // end, and the position of the sample on the ramp
+    alignas(32) T sgain[Lanes], sg[Lanes], sr2[Lanes], sk[Lanes], sdenom[Lanes];
+    alignas(32) T dgain[Lanes], dg[Lanes], dr2[Lanes], dk[Lanes], ddenom[Lanes];
+    unsigned position;
+    T delta;
+
+    void load(const SVFBank &bank, unsigned first);
+    void loadRamp(const SVFBank &bank, unsigned first, unsigned count);
+    void store(SVFBank &bank, unsigned first) const;
+    template <int FilterType, int Character> T tick(unsigned c, T x);
+    void step();
+    template <int FilterType>
+    void processLinear(const LinearBlock &lb, unsigned first, const float *const *inputs, float *const *outputs, unsigned channels, unsigned count);
+};
+
+template <class T, unsigned Lanes>
+void SVFBank::LaneBlock<T, Lanes>::load(const SVFBank &bank, unsigned first)
+{
+    const Coefficients &coefs = bank.fCoefs;
+    for (unsigned l = 0; l < Lanes; ++l) {
+        gain[l] = coefs.gain[first + l];
+        g[l] = coefs.g[first + l];
+        r2[l] = coefs.r2[first + l];
+        k[l] = coefs.k[first + l];
+        denom[l] = coefs.denom[first + l];
+    }
+
+    for (unsigned c = 0; c < bank.fNumChannels; ++c) {
+        const ChannelState &state = bank.fStates[c];
+        for (unsigned l = 0; l < Lanes; ++l) {
+            z1[c][l] = state.z1[first + l];
+            z2[c][l] = state.z2[first + l];
+            v1[c][l] = state.v1[first + l];
+            v2[c][l] = state.v2[first + l];
+            a1[c][l] = analogSaturateResidueIntegral<T>(v1[c][l]);
+            a2[c][l] = analogSaturateResidueIntegral<T>(v2[c][l]);
+        }
+    }
+}
+
+template <class T, unsigned Lanes>
+void SVFBank::LaneBlock<T, Lanes>::loadRamp(const SVFBank &bank, unsigned first, unsigned count)
+{
+    const Coefficients &start = bank.fRampCoefs;
+    const Coefficients &target = bank.fTargetCoefs;
+
+    for (unsigned l = 0; l < Lanes; ++l) {
+        sgain[l] = start.gain[first + l];
+        sg[l] = start.g[first + l];
+        sr2[l] = start.r2[first + l];
+        sk[l] = start.k[first + l];
+        sdenom[l] = start.denom[first + l];
+        dgain[l] = target.gain[first + l] - start.gain[first + l];
+        dg[l] = target.g[first + l] - start.g[first + l];
+        dr2[l] = target.r2[first + l] - start.r2[first + l];
+        dk[l] = target.k[first + l] - start.k[first + l];
+        ddenom[l] = target.denom[first + l] - start.denom[first + l];
+    }
+
+    // the span is counted at the rate of the caller, the block may run at a
+    // multiple of it
+    unsigned span = bank.fRampEnd - bank.fRampBegin;
+    unsigned scale = (count > span) ? (count / span) : 1;
+    assert(count == 0 || scale * span == count);
+    position = bank.fRampBegin * scale;
+    delta = T(1) / T(bank.fRampLength * scale);
+}
+
+template <class T, unsigned Lanes>
+inline void SVFBank::LaneBlock<T, Lanes>::step()
+{
+    const T t = T(++position) * delta;
+    for (unsigned l = 0; l < Lanes; ++l) {
+        gain[l] = sgain[l] + t * dgain[l];
+        g[l] = sg[l] + t * dg[l];
+        r2[l] = sr2[l] + t * dr2[l];
+        k[l] = sk[l] + t * dk[l];
+        denom[l] = sdenom[l] + t * ddenom[l];
+    }
+}
+
+template <class T, unsigned Lanes>
+void SVFBank::LaneBlock<T, Lanes>::store(SVFBank &bank, unsigned first) const
+{
+    for (unsigned c = 0; c < bank.fNumChannels; ++c) {
+        ChannelState &state = bank.fStates[c];
+        for (unsigned l = 0; l < Lanes; ++l) {
+            state.z1[first + l] = z1[c][l];
+            state.z2[first + l] = z2[c][l];
+            state.v1[first + l] = v1[c][l];
+            state.v2[first + l] = v2[c][l];
+        }
+    }
+}
+
+template <class T, unsigned Lanes>
+template <int FilterType, int Character>
+inline T SVFBank::LaneBlock<T, Lanes>::tick(unsigned c, T x)
+{
+    T sum = 0;
+
+    for (unsigned l = 0; l < Lanes; ++l) {
+        T in = gain[l] * x;
+
+        // the solution of the linear loop
+        T HP = (in - (r2[l] + g[l]) * z1[c][l] - z2[c][l]) * denom[l];
+        T BP, LP;
+
+        if_constexpr (Character == LinearCharacter) {
+            BP = HP * g[l] + z1[c][l];
+            LP = BP * g[l] + z2[c][l];
+
+            z1[c][l] = 2 * BP - z1[c][l];
+            z2[c][l] = 2 * LP - z2[c][l];
+        }
+        else if_constexpr (Character == SaturatingCharacter) {
+            BP = HP * g[l] + z1[c][l];
+            LP = BP * g[l] + z2[c][l];
+
+            z1[c][l] = analogSaturate(g[l] * HP + BP);
+            z2[c][l] = analogSaturate(g[l] * BP + LP);
+        }
+        else if_constexpr (Character == AntialiasedCharacter) {
+            BP = HP * g[l] + z1[c][l];
+            LP = BP * g[l] + z2[c][l];
+
+            T u1 = g[l] * HP + BP;
+            T u2 = g[l] * BP + LP;
+            z1[c][l] = analogSaturateAntialiased(u1, v1[c][l], a1[c][l]);
+            z2[c][l] = analogSaturateAntialiased(u2, v2[c][l], a2[c][l]);
+            v1[c][l] = u1;
+            v2[c][l] = u2;
+        }
+        else {
+            // The integrators saturate at their inputs, within the loop:
+            // HP = in - 2R BP - LP, BP = g f(HP) + z1, LP = g f(BP) + z2.
+            // The residue has a slope of 1 at least, Newton converges
+            // quickly from the linear solution.
+            for (unsigned it = 0; it < NewtonIterations; ++it) {
+                BP = g[l] * analogSaturate(HP) + z1[c][l];
+                LP = g[l] * analogSaturate(BP) + z2[c][l];
+                T residue = HP - in + r2[l] * BP + LP;
+                T slope = 1 + g[l] * analogSaturateSlope(HP) * (r2[l] + g[l] * analogSaturateSlope(BP));
+                HP -= residue / slope;
+            }
+
+            T u1 = g[l] * analogSaturate(HP);
+            BP = u1 + z1[c][l];
+            T u2 = g[l] * analogSaturate(BP);
+            LP = u2 + z2[c][l];
+
+            z1[c][l] = BP + u1;
+            z2[c][l] = LP + u2;
+        }
+
+        T out = 0;
+        if_constexpr (FilterType == SVFLowpass)
+            out = LP;
+        else if_constexpr (FilterType == SVFBandpass)
+            out = BP;
+        else if_constexpr (FilterType == SVFHighpass)
+            out = HP;
+        else if_constexpr (FilterType == SVFUnitGainBandpass)
+            out = r2[l] * BP;
+        else if_constexpr (FilterType == SVFBandShelving)
+            out = in + r2[l] * k[l] * BP;
+        else if_constexpr (FilterType == SVFNotch)
+            out = in - r2[l] * BP;
+        else if_constexpr (FilterType == SVFAllpass)
+            out = in - 2 * r2[l] * BP;
+        else if_constexpr (FilterType == SVFPeak)
+            out = LP - HP;
+
+        sum += out;
+    }
+
+    return sum;
+}
+
+template <class T, unsigned Lanes>
+template <int FilterType>
+void SVFBank::LaneBlock<T, Lanes>::processLinear(const LinearBlock &lb, unsigned first, const float *const *inputs, float *const *outputs, unsigned channels, unsigned count)
+{
+    const unsigned L = LinearBlockLength;
+
+    // The matrices are laid out for products as sums of scaled vectors,
+    // over the samples of the block or over the lanes. The bands share
+    // the input, their impulses sum up in a lower triangular matrix.
+    // The padding lanes have no input, their states stay at zero.
+    alignas(32) T impulse[L][L];
+    alignas(32) T observe[2][Lanes][L];
+    alignas(32) T control[L][2][Lanes];
+    alignas(32) T transition[2][2][Lanes];
+
+    for (unsigned j = 0; j < L; ++j) {
+        for (unsigned i = 0; i < L; ++i)
+            impulse[j][i] = 0;
+    }
+    for (unsigned l = 0; l < Lanes; ++l) {
+        const bool active = first + l < NumBands;
+        for (unsigned j = 0; j < L; ++j) {
+            for (unsigned i = j; i < L && active; ++i)
+                impulse[j][i] += lb.impulse[first + l][i - j];
+        }
+        for (unsigned s = 0; s < 2; ++s) {
+            for (unsigned i = 0; i < L; ++i) {
+                observe[s][l][i] = active ? lb.observe[first + l][s][i] : 0;
+                control[i][s][l] = active ? lb.control[first + l][s][i] : 0;
+            }
+            for (unsigned t = 0; t < 2; ++t)
+                transition[s][t][l] = active ? lb.transition[first + l][s][t] : 0;
+        }
+    }
+
+    const unsigned blocked = count - count % L;
+
+    for (unsigned c = 0; c < channels; ++c) {
+        const float *input = inputs[c];
+        float *output = outputs[c];
+
+        for (unsigned i = 0; i < blocked; i += L) {
+            alignas(32) T x[L];
+            alignas(32) T y[L];
+            alignas(32) T s1[Lanes];
+            alignas(32) T s2[Lanes];
+
+            for (unsigned j = 0; j < L; ++j) {
+                x[j] = input[i + j];
+                y[j] = 0;
+            }
+
+            // the samples of the block are independent, they vectorize
+            for (unsigned j = 0; j < L; ++j) {
+                for (unsigned n = 0; n < L; ++n)
+                    y[n] += impulse[j][n] * x[j];
+            }
+            for (unsigned l = 0; l < Lanes; ++l) {
+                for (unsigned n = 0; n < L; ++n)
+                    y[n] += observe[0][l][n] * z1[c][l] + observe[1][l][n] * z2[c][l];
+            }
+
+            for (unsigned l = 0; l < Lanes; ++l) {
+                s1[l] = transition[0][0][l] * z1[c][l] + transition[0][1][l] * z2[c][l];
+                s2[l] = transition[1][0][l] * z1[c][l] + transition[1][1][l] * z2[c][l];
+            }
+            for (unsigned j = 0; j < L; ++j) {
+                for (unsigned l = 0; l < Lanes; ++l) {
+                    s1[l] += control[j][0][l] * x[j];
+                    s2[l] += control[j][1][l] * x[j];
+                }
+            }
+            for (unsigned l = 0; l < Lanes; ++l) {
+                z1[c][l] = s1[l];
+                z2[c][l] = s2[l];
+            }
+
+            for (unsigned j = 0; j < L; ++j)
+                output[i + j] = y[j];
+        }
+
+        for (unsigned i = blocked; i < count; ++i)
+            output[i] = tick<FilterType, LinearCharacter>(c, input[i]);
+    }
+}
+
+template <int FilterType, int Character, class T, unsigned Lanes>
+void SVFBank::processInternally(unsigned first, const float *const *inputs, float *const *outputs, unsigned count)
+{
+    const unsigned channels = fNumChannels;
+
+    LaneBlock<T, Lanes> block;
+    block.load(*this, first);
+
+    if (Character == LinearCharacter && !fRamping && channels == 1) {
+        if (!fLinearBlockValid)
+            updateLinearBlock();
+        block.template processLinear<FilterType>(fLinearBlock, first, inputs, outputs, channels, count);
+    }
+    else if (!fRamping) {
+        for (unsigned i = 0; i < count; ++i) {
+            // the channels are independent, their recurrences interleave
+            for (unsigned c = 0; c < channels; ++c)
+                outputs[c][i] = block.template tick<FilterType, Character>(c, inputs[c][i]);
+        }
+    }
+    else {
+        block.loadRamp(*this, first, count);
+        for (unsigned i = 0; i < count; ++i) {
+            block.step();
+            for (unsigned c = 0; c < channels; ++c)
+                outputs[c][i] = block.template tick<FilterType, Character>(c, inputs[c][i]);
+        }
+    }
+
+    block.store(*this, first);
+}
+
+template <int FilterType, int Character, class T>
+void SVFBank::processMultirateInternally(const float *const *baseInputs, float *const *baseOutputs, const float *const *inputs, float *const *outputs, unsigned count, unsigned ratio)
+{
+    const unsigned channels = fNumChannels;
+
+    LaneBlock<T, 1> low;
+    LaneBlock<T, 2> high;
+    low.load(*this, 0);
+    high.load(*this, 1);
+
+    if (Character == LinearCharacter && !fRamping && channels == 1) {
+        if (!fLinearBlockValid)
+            updateLinearBlock();
+        low.template processLinear<FilterType>(fLinearBlock, 0, baseInputs, baseOutputs, channels, count);
+        high.template processLinear<FilterType>(fLinearBlock, 1, inputs, outputs, channels, count * ratio);
+    }
+    else if (!fRamping) {
+        for (unsigned i = 0; i < count; ++i) {
+            // the low band is independent, it fills the latency of the others
+            for (unsigned c = 0; c < channels; ++c)
+                baseOutputs[c][i] = low.template tick<FilterType, Character>(c, baseInputs[c][i]);
+
+            for (unsigned j = i * ratio; j < (i + 1) * ratio; ++j) {
+                for (unsigned c = 0; c < channels; ++c)
+                    outputs[c][j] = high.template tick<FilterType, Character>(c, inputs[c][j]);
+            }
+        }
+    }
+    else {
+        low.loadRamp(*this, 0, count);
+        high.loadRamp(*this, 1, count * ratio);
+        for (unsigned i = 0; i < count; ++i) {
+            low.step();
+            for (unsigned c = 0; c < channels; ++c)
+                baseOutputs[c][i] = low.template tick<FilterType, Character>(c, baseInputs[c][i]);
+
+            for (unsigned j = i * ratio; j < (i + 1) * ratio; ++j) {
+                high.step();
+                for (unsigned c = 0; c < channels; ++c)
+                    outputs[c][j] = high.template tick<FilterType, Character>(c, inputs[c][j]);
+            }
+        }
+    }
+
+    low.store(*this, 0);
+    high.store(*this, 1);
+}
+
+void SVFBank::process(const float *const *inputs, float *const *outputs, unsigned count)
+{
+    if (fPrecision == SinglePrecision)
+        processWithPrecision<float>(inputs, outputs, count);
+    else
+        processWithPrecision<double>(inputs, outputs, count);
+
+    advanceRamp();
+}
+
+template <class T>
+void SVFBank::processWithPrecision(const float *const *inputs, float *const *outputs, unsigned count)
+{
+    switch (fCharacter) {
+    case LinearCharacter:
+        processWithCharacter<T, LinearCharacter>(inputs, outputs, count);
+        break;
+    default:
+    case SaturatingCharacter:
+        processWithCharacter<T, SaturatingCharacter>(inputs, outputs, count);
+        break;
+    case ImplicitCharacter:
+        processWithCharacter<T, ImplicitCharacter>(inputs, outputs, count);
+        break;
+    case AntialiasedCharacter:
+        processWithCharacter<T, AntialiasedCharacter>(inputs, outputs, count);
+        break;
+    }
+}
+
+template <class T, int Character>
+void SVFBank::processWithCharacter(const float *const *inputs, float *const *outputs, unsigned count)
+{
+    switch (fFilterType) {
+    case SVFLowpass:
+        processInternally<SVFLowpass, Character, T, NumLanes>(0, inputs, outputs, count);
+        break;
+    case SVFBandpass:
+        processInternally<SVFBandpass, Character, T, NumLanes>(0, inputs, outputs, count);
+        break;
+    case SVFHighpass:
+        processInternally<SVFHighpass, Character, T, NumLanes>(0, inputs, outputs, count);
+        break;
+    case SVFUnitGainBandpass:
+        processInternally<SVFUnitGainBandpass, Character, T, NumLanes>(0, inputs, outputs, count);
+        break;
+    case SVFBandShelving:
+        processInternally<SVFBandShelving, Character, T, NumLanes>(0, inputs, outputs, count);
+        break;
+    case SVFNotch:
+        processInternally<SVFNotch, Character, T, NumLanes>(0, inputs, outputs, count);
+        break;
+    case SVFAllpass:
+        processInternally<SVFAllpass, Character, T, NumLanes>(0, inputs, outputs, count);
+        break;
+    case SVFPeak:
+        processInternally<SVFPeak, Character, T, NumLanes>(0, inputs, outputs, count);
+        break;
+    default: {
+        double gain = 0.0;
+        for (unsigned l = 0; l < NumLanes; ++l)
+            gain += fCoefs.gain[l];
+        for (unsigned c = 0; c < fNumChannels; ++c) {
+            for (unsigned i = 0; i < count; ++i)
+                outputs[c][i] = gain * inputs[c][i];
+        }
+    }
+    }
+}
+
+void SVFBank::processMultirate(const float *const *baseInputs, float *const *baseOutputs, const float *const *inputs, float *const *outputs, unsigned count, unsigned ratio)
+{
+    if (fPrecision == SinglePrecision)
+        processMultirateWithPrecision<float>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+    else
+        processMultirateWithPrecision<double>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+
+    advanceRamp();
+}
+
+template <class T>
+void SVFBank::processMultirateWithPrecision(const float *const *baseInputs, float *const *baseOutputs, const float *const *inputs, float *const *outputs, unsigned count, unsigned ratio)
+{
+    switch (fCharacter) {
+    case LinearCharacter:
+        processMultirateWithCharacter<T, LinearCharacter>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    default:
+    case SaturatingCharacter:
+        processMultirateWithCharacter<T, SaturatingCharacter>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case ImplicitCharacter:
+        processMultirateWithCharacter<T, ImplicitCharacter>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case AntialiasedCharacter:
+        processMultirateWithCharacter<T, AntialiasedCharacter>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    }
+}
+
+template <class T, int Character>
+void SVFBank::processMultirateWithCharacter(const float *const *baseInputs, float *const *baseOutputs, const float *const *inputs, float *const *outputs, unsigned count, unsigned ratio)
+{
+    switch (fFilterType) {
+    case SVFLowpass:
+        processMultirateInternally<SVFLowpass, Character, T>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case SVFBandpass:
+        processMultirateInternally<SVFBandpass, Character, T>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case SVFHighpass:
+        processMultirateInternally<SVFHighpass, Character, T>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case SVFUnitGainBandpass:
+        processMultirateInternally<SVFUnitGainBandpass, Character, T>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case SVFBandShelving:
+        processMultirateInternally<SVFBandShelving, Character, T>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case SVFNotch:
+        processMultirateInternally<SVFNotch, Character, T>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case SVFAllpass:
+        processMultirateInternally<SVFAllpass, Character, T>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    case SVFPeak:
+        processMultirateInternally<SVFPeak, Character, T>(baseInputs, baseOutputs, inputs, outputs, count, ratio);
+        break;
+    default:
+        for (unsigned c = 0; c < fNumChannels; ++c) {
+            for (unsigned i = 0; i < count; ++i)
+                baseOutputs[c][i] = fCoefs.gain[0] * baseInputs[c][i];
+            for (unsigned i = 0; i < count * ratio; ++i)
+                outputs[c][i] = (fCoefs.gain[1] + fCoefs.gain[2]) * inputs[c][i];
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "svf/VAStateVariableFilter.h"
+
+// The 3 bands of the resonator in vector lanes, padded to 4.
+// It processes all bands of all channels in a single sweep, and outputs
+// the sum of bands for every channel. The channels share coefficients,
+// and each has its state apart, in 128 contiguous bytes.
+class SVFBank {
+public:
+    enum { NumBands = 3, NumLanes = 4, MaximumChannels = 8 };
+
+    SVFBank();
+
+    void setNumChannels(unsigned channels);
+    void setFilterType(int type);
+
+    // the state is kept in double precision, and the filters run in the
+    // precision chosen. The lanes are the same in both, single precision
+    // holds them in one SSE vector instead of two.
+    enum Precision {
+        DoublePrecision,
+        SinglePrecision,
+    };
+    void setPrecision(int precision);
+    int getPrecision() const;
+
+    // the nonlinearity: none, saturation of the states after each step,
+    // saturation of the integrator inputs solved within the loop, or
+    // saturation of the states with first-order antiderivative antialiasing
+    enum Character {
+        LinearCharacter,
+        SaturatingCharacter,
+        ImplicitCharacter,
+        AntialiasedCharacter,
+    };
+    void setCharacter(int character);
+    int getCharacter() const;
+    void setBand(unsigned nth, const VAStateVariableFilter &filter, float gain);
+    // the coefficients move linearly to the new ones over the next process
+    void rampBand(unsigned nth, const VAStateVariableFilter &filter, float gain);
+    // the next process covers only this span of the ramp, from begin to end
+    // out of its length, in samples of the caller. The ramp goes on over
+    // the processes which follow, until a span reaches the length. Every
+    // sample is placed on the ramp by its position, the coefficients do not
+    // depend on how it is split.
+    void setRampSpan(unsigned begin, unsigned end, unsigned length);
+    // the coefficients go over the span, as after a process, without one
+    void skipRamp();
+    void clear();
+    // the largest magnitude of the states of a channel
+    double getStateMagnitude(unsigned channel) const;
+
+    void process(const float *const *inputs, float *const *outputs, unsigned count);
+    // processes the first band at the base rate, and the others at the
+    // oversampled rate, `count` being the number of samples at base rate
+    void processMultirate(const float *const *baseInputs, float *const *baseOutputs, const float *const *inputs, float *const *outputs, unsigned count, unsigned ratio);
+
+private:
+    template <class T, unsigned Lanes> struct LaneBlock;
+
+    void finishRamp();
+    void advanceRamp();
+    void updateLinearBlock();
+
+    struct Coefficients {
+        double gain[NumLanes];
+        double g[NumLanes];
+        double r2[NumLanes];
+        double k[NumLanes];
+        double denom[NumLanes];
+    };
+
+    struct ChannelState {
+        double z1[NumLanes];
+        double z2[NumLanes];
+        // the last inputs of the state saturators, for antialiasing
+        double v1[NumLanes];
+        double v2[NumLanes];
+    };
+    // the bank is not over-aligned, it lives in objects which the hosts
+    // allocate, so the states of the channels follow each other with no
+    // padding, rather than each on its own cache lines
+    static_assert(sizeof(ChannelState) == 128, "The state of a channel should take 128 bytes");
+
+    // The linear model as a state space over blocks of samples, which
+    // computes a block without recurrence between its samples.
+    // Over a block x, the output is y = impulse * x + observe * z,
+    // and the next state is z = transition * z + control * x.
+    // It serves the mono case, where the recurrences are too few to fill
+    // the pipeline, the channels interleaving otherwise.
+    enum { LinearBlockLength = 8 };
+    struct LinearBlock {
+        double impulse[NumLanes][LinearBlockLength];
+        double observe[NumLanes][2][LinearBlockLength];
+        double control[NumLanes][2][LinearBlockLength];
+        double transition[NumLanes][2][2];
+    };
+
+    template <class T>
+    void processWithPrecision(const float *const *inputs, float *const *outputs, unsigned count);
+    template <class T>
+    void processMultirateWithPrecision(const float *const *baseInputs, float *const *baseOutputs, const float *const *inputs, float *const *outputs, unsigned count, unsigned ratio);
+    template <class T, int Character>
+    void processWithCharacter(const float *const *inputs, float *const *outputs, unsigned count);
+    template <class T, int Character>
+    void processMultirateWithCharacter(const float *const *baseInputs, float *const *baseOutputs, const float *const *inputs, float *const *outputs, unsigned count, unsigned ratio);
+    template <int FilterType, int Character, class T, unsigned Lanes>
+    void processInternally(unsigned first, const float *const *inputs, float *const *outputs, unsigned count);
+    template <int FilterType, int Character, class T>
+    void processMultirateInternally(const float *const *baseInputs, float *const *baseOutputs, const float *const *inputs, float *const *outputs, unsigned count, unsigned ratio);
+
+private:
+    unsigned fNumChannels;
+    int fFilterType;
+    int fPrecision = DoublePrecision;
+    int fCharacter = SaturatingCharacter;
+    enum { NewtonIterations = 4 };
+
+    // coefficients, those at the start and at the end of the ramp
+    Coefficients fCoefs;
+    Coefficients fRampCoefs;
+    Coefficients fTargetCoefs;
+    bool fRamping = false;
+    unsigned fRampBegin = 0;
+    unsigned fRampEnd = 1;
+    unsigned fRampLength = 1;
+
+    // the linear model of the coefficients, computed when first needed
+    LinearBlock fLinearBlock;
+    bool fLinearBlockValid = false;
+
+    // state
+    ChannelState fStates[MaximumChannels];
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// Memory arena which allocates only on reserve.
+// Objects are placed one after the other, each on a 64-byte boundary, and
+// they are dropped all at once on clear. They must not need destruction.
+class Arena {
+public:
+    enum { Alignment = 64 };
+
+    // the space taken by an array of objects, once aligned
+    template <class T> static std::size_t getSize(unsigned count);
+
+    // drops the objects, and grows the memory to the capacity if needed
+    void reserve(std::size_t capacity);
+    void clear();
+
+    // an array of default constructed objects, or null if out of space
+    template <class T> T *construct(unsigned count);
+
+private:
+    std::unique_ptr<char[]> fMem;
+    char *fBase = nullptr;
+    std::size_t fCapacity = 0;
+    std::size_t fUsed = 0;
+};
+
+//------------------------------------------------------------------------------
+template <class T>
+inline std::size_t Arena::getSize(unsigned count)
+{
+    static_assert(alignof(T) <= Alignment, "The alignment is not supported");
+    std::size_t size = count * sizeof(T);
+    return (size + Alignment - 1) & ~(std::size_t)(Alignment - 1);
+}
+
+inline void Arena::reserve(std::size_t capacity)
+{
+    fUsed = 0;
+    if (capacity <= fCapacity)
+        return;
+
+    fMem.reset(new char[capacity + Alignment - 1]);
+    std::uintptr_t address = (std::uintptr_t)fMem.get();
+    address = (address + Alignment - 1) & ~(std::uintptr_t)(Alignment - 1);
+    fBase = (char *)address;
+    fCapacity = capacity;
+}
+
+inline void Arena::clear()
+{
+    fUsed = 0;
+}
+
+template <class T>
+inline T *Arena::construct(unsigned count)
+{
+    static_assert(std::is_trivially_destructible<T>::value, "The objects must not need destruction");
+
+    std::size_t size = getSize<T>(count);
+    if (size > fCapacity - fUsed)
+        return nullptr;
+
+    T *objects = (T *)(fBase + fUsed);
+    for (unsigned i = 0; i < count; ++i)
+        new (&objects[i]) T;
+    fUsed += size;
+    return objects;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <memory>
+
+// Delay line which allocates only on resize.
+// It is written a block at a time, and the same block is read back delayed.
+class DelayLine {
+public:
+    // capacity = maximum delay + maximum block size
+    void resize(unsigned capacity);
+    void clear();
+    void write(const float *in, unsigned n);
+    void read(float *out, unsigned n, unsigned delay) const;
+
+private:
+    std::unique_ptr<float[]> fMem;
+    unsigned fSize = 0;
+    unsigned fIndex = 0;
+};
+
+//------------------------------------------------------------------------------
+inline void DelayLine::resize(unsigned capacity)
+{
+    fMem.reset(new float[capacity]);
+    fSize = capacity;
+    clear();
+}
+
+inline void DelayLine::clear()
+{
+    for (unsigned i = 0; i < fSize; ++i)
+        fMem[i] = 0;
+    fIndex = 0;
+}
+
+inline void DelayLine::write(const float *in, unsigned n)
+{
+    float *mem = fMem.get();
+    unsigned size = fSize;
+    unsigned index = fIndex;
+    for (unsigned i = 0; i < n; ++i) {
+        mem[index] = in[i];
+        index = (index + 1 == size) ? 0 : (index + 1);
+    }
+    fIndex = index;
+}
+
+inline void DelayLine::read(float *out, unsigned n, unsigned delay) const
+{
+    const float *mem = fMem.get();
+    unsigned size = fSize;
+    unsigned index = fIndex + 2 * size - n - delay;
+    index = (index >= size) ? (index - size) : index;
+    index = (index >= size) ? (index - size) : index;
+    for (unsigned i = 0; i < n; ++i) {
+        out[i] = mem[index];
+        index = (index + 1 == size) ? 0 : (index + 1);
+    }
+}
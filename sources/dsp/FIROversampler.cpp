@@ -0,0 +1,44 @@
+#include "FIROversampler.h"
+#include <cmath>
+#include <cassert>
+
+static double besselI0(double x)
+{
+    double sum = 1;
+    double term = 1;
+    for (unsigned k = 1; k < 64; ++k) {
+        double t = x / (2 * k);
+        term *= t * t;
+        sum += term;
+        if (term < sum * 1e-17)
+            break;
+    }
+    return sum;
+}
+
+void designHalfbandFIR(double taps[], unsigned length, double beta)
+{
+    // Kaiser-windowed sinc at the quarter of the sample rate
+    assert(length % 4 == 3);
+
+    unsigned center = (length - 1) / 2;
+    double norm = 1.0 / besselI0(beta);
+
+    for (unsigned n = 0; n < length; ++n) {
+        double d = 0.5 * ((double)n - (double)center);
+        double sinc = (d == 0) ? 1.0 : (std::sin(M_PI * d) / (M_PI * d));
+        double r = 2.0 * n / (length - 1) - 1.0;
+        double window = besselI0(beta * std::sqrt(1.0 - r * r)) * norm;
+        taps[n] = 0.5 * sinc * window;
+    }
+
+    // make the even taps sum to 1/2, and the center tap 1/2, for unity gain
+    double sum = 0;
+    for (unsigned n = 0; n < length; n += 2)
+        sum += taps[n];
+    for (unsigned n = 0; n < length; n += 2)
+        taps[n] *= 0.5 / sum;
+    for (unsigned n = 1; n < length; n += 2)
+        taps[n] = 0;
+    taps[center] = 0.5;
+}
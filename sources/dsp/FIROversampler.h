@@ -0,0 +1,178 @@
+#pragma once
+#include "HalfbandCascade.h"
+
+// Linear-phase FIR half-band filter, of length 4*K-1.
+// Every other tap is zero except the center one, so the upsampler computes
+// one dot product of 2*K taps per input sample, the other phase being a
+// pure delay, and the downsampler one dot product plus a single tap.
+// The input is processed in chunks placed after the history, in linear
+// memory, and the dot products are computed for all outputs at once.
+// The taps are designed once per process, and shared by all instances.
+void designHalfbandFIR(double taps[], unsigned length, double beta);
+
+template <unsigned K>
+class HalfbandFIR {
+public:
+    enum { Length = 4 * K - 1 };
+
+    struct Kernel {
+        explicit Kernel(double beta);
+        // nonzero taps besides the center one, time-reversed
+        alignas(32) float taps[2 * K];
+    };
+
+    void init(const Kernel &kernel);
+    void reset();
+
+    // n samples in, 2 * n samples out
+    void upsample(const float *in, float *out, unsigned n);
+    // 2 * n samples in, n samples out
+    void downsample(const float *in, float *out, unsigned n);
+
+    // in samples of the higher rate
+    static double getUpsampleLatency() { return 2 * K - 1; }
+    static double getDownsampleLatency() { return 2 * K - 2; }
+
+private:
+    enum { Chunk = 64, History = 2 * K - 1 };
+
+    // filters a chunk which is placed after the history, updates the history
+    void filterChunk(float *buffer, float *acc, unsigned n);
+
+private:
+    const Kernel *fKernel = nullptr;
+
+    float fUpBuffer[History + Chunk] = {};
+    // odd and even input samples
+    float fDownBuffer[History + Chunk] = {};
+    float fDownDelay[History + Chunk] = {};
+};
+
+template <int Quality> struct FIRHalfbandDesign;
+
+template <> struct FIRHalfbandDesign<HalfbandEconomy> {
+    typedef HalfbandFIR<4> FirstStage;
+    typedef HalfbandFIR<3> NextStage;
+    static void initFirstStage(FirstStage &stage) { static const FirstStage::Kernel kernel(5.0); stage.init(kernel); }
+    static void initNextStage(NextStage &stage, unsigned) { static const NextStage::Kernel kernel(6.0); stage.init(kernel); }
+};
+
+template <> struct FIRHalfbandDesign<HalfbandStandard> {
+    typedef HalfbandFIR<8> FirstStage;
+    typedef HalfbandFIR<6> NextStage;
+    static void initFirstStage(FirstStage &stage) { static const FirstStage::Kernel kernel(7.0); stage.init(kernel); }
+    static void initNextStage(NextStage &stage, unsigned) { static const NextStage::Kernel kernel(8.0); stage.init(kernel); }
+};
+
+template <> struct FIRHalfbandDesign<HalfbandHigh> {
+    typedef HalfbandFIR<16> FirstStage;
+    typedef HalfbandFIR<8> NextStage;
+    static void initFirstStage(FirstStage &stage) { static const FirstStage::Kernel kernel(10.0); stage.init(kernel); }
+    static void initNextStage(NextStage &stage, unsigned) { static const NextStage::Kernel kernel(10.0); stage.init(kernel); }
+};
+
+// Cascade of FIR half-band stages, with linear phase.
+template <unsigned R, int Quality = HalfbandStandard>
+class FIROversampler : public HalfbandCascade<FIRHalfbandDesign<Quality>, R> {
+};
+
+//------------------------------------------------------------------------------
+template <unsigned K>
+HalfbandFIR<K>::Kernel::Kernel(double beta)
+{
+    double design[Length];
+    designHalfbandFIR(design, Length, beta);
+    for (unsigned k = 0; k < 2 * K; ++k)
+        taps[k] = design[2 * (2 * K - 1 - k)];
+}
+
+template <unsigned K>
+void HalfbandFIR<K>::init(const Kernel &kernel)
+{
+    fKernel = &kernel;
+    reset();
+}
+
+template <unsigned K>
+void HalfbandFIR<K>::reset()
+{
+    for (unsigned k = 0; k < History + Chunk; ++k) {
+        fUpBuffer[k] = 0;
+        fDownBuffer[k] = 0;
+        fDownDelay[k] = 0;
+    }
+}
+
+template <unsigned K>
+void HalfbandFIR<K>::filterChunk(float *buffer, float *acc, unsigned n)
+{
+    const float *taps = fKernel->taps;
+
+    for (unsigned i = 0; i < n; ++i)
+        acc[i] = 0;
+    for (unsigned k = 0; k < 2 * K; ++k) {
+        const float t = taps[k];
+        const float *w = &buffer[k];
+        for (unsigned i = 0; i < n; ++i)
+            acc[i] += t * w[i];
+    }
+}
+
+template <unsigned K>
+void HalfbandFIR<K>::upsample(const float *in, float *out, unsigned n)
+{
+    float *buffer = fUpBuffer;
+    float acc[Chunk];
+
+    while (n > 0) {
+        unsigned current = (n < Chunk) ? n : (unsigned)Chunk;
+
+        for (unsigned i = 0; i < current; ++i)
+            buffer[History + i] = in[i];
+        filterChunk(buffer, acc, current);
+
+        // taps are scaled by 2 for the upsampler, the center tap is 1
+        for (unsigned i = 0; i < current; ++i) {
+            out[2 * i] = 2 * acc[i];
+            out[2 * i + 1] = buffer[i + K];
+        }
+
+        for (unsigned k = 0; k < History; ++k)
+            buffer[k] = buffer[current + k];
+
+        in += current;
+        out += 2 * current;
+        n -= current;
+    }
+}
+
+template <unsigned K>
+void HalfbandFIR<K>::downsample(const float *in, float *out, unsigned n)
+{
+    float *buffer = fDownBuffer;
+    float *delay = fDownDelay;
+    float acc[Chunk];
+
+    while (n > 0) {
+        unsigned current = (n < Chunk) ? n : (unsigned)Chunk;
+
+        for (unsigned i = 0; i < current; ++i) {
+            buffer[History + i] = in[2 * i + 1];
+            delay[History + i] = in[2 * i];
+        }
+        filterChunk(buffer, acc, current);
+
+        // the center tap is 1/2
+        for (unsigned i = 0; i < current; ++i)
+            out[i] = acc[i] + 0.5f * delay[i + K];
+
+        for (unsigned k = 0; k < History; ++k) {
+            buffer[k] = buffer[current + k];
+            delay[k] = delay[current + k];
+        }
+
+        in += 2 * current;
+        out += current;
+        n -= current;
+    }
+}
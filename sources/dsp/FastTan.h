@@ -0,0 +1,22 @@
+#pragma once
+#include <cmath>
+
+// Tangent for the prewarping of filter cutoffs, x in [0, pi/2).
+//
+// The [7/6] Pade approximant of the continued fraction of Lambert is used
+// on [0, pi/4], and tan(x) = 1 / tan(pi/2 - x) above, so a single division
+// is needed. The relative error is under 2e-13 on [0, pi/4], and stays
+// under 1e-12 up to x = 0.49 pi, the reflection adding the rounding of
+// pi/2 - x relative to itself. This is far under the resolution of the
+// single precision audio path.
+inline double fastTan(double x)
+{
+    bool reflect = x > M_PI / 4;
+    x = reflect ? (M_PI / 2 - x) : x;
+
+    double x2 = x * x;
+    double num = x * (135135.0 + x2 * (-17325.0 + x2 * (378.0 - x2)));
+    double den = 135135.0 + x2 * (-62370.0 + x2 * (3150.0 - 28.0 * x2));
+
+    return reflect ? (den / num) : (num / den);
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <cstring>
+#include <cmath>
+
+// Oversampler by a cascade of 2x half-band stages.
+//
+// The first stage operates at the base rate and needs a sharp transition.
+// The next ones see signals already band-limited, and they can afford wide
+// transitions, hence short filters. The design provides the stage types,
+// and initializes the stages with kernels of static storage, which are
+// computed on first use and shared by all instances:
+//
+// struct Design {
+//     typedef ... FirstStage;
+//     typedef ... NextStage;
+//     static void initFirstStage(FirstStage &stage);
+//     static void initNextStage(NextStage &stage, unsigned index);
+// };
+//
+// A stage implements `reset()`, `upsample(in, out, n)` which produces 2*n
+// samples, and `downsample(in, out, n)` which consumes 2*n samples.
+// It reports `getUpsampleLatency()` and `getDownsampleLatency()`, the delay
+// of each operation in samples of the higher rate.
+//
+// The round trip is padded to a whole number of samples of the base rate,
+// so the latency can be compensated exactly on the dry path.
+
+// Designs come in tiers, which trade CPU for the rejection of images.
+enum HalfbandQuality {
+    HalfbandEconomy,
+    HalfbandStandard,
+    HalfbandHigh,
+};
+
+template <class Design, unsigned R>
+class HalfbandCascade {
+public:
+    enum { Ratio = R };
+
+    HalfbandCascade();
+    void reset();
+
+    // latency of the round trip, in samples of the base rate
+    unsigned getLatency() const { return fLatency; }
+
+    // n samples in, n * Ratio samples out
+    void upsampleBlock(const float *in, float *out, unsigned n);
+    // n * Ratio samples in, n samples out
+    void downsampleBlock(const float *in, float *out, unsigned n);
+
+private:
+    static constexpr unsigned stagesForRatio(unsigned r) { return (r > 1) ? (1 + stagesForRatio(r / 2)) : 0; }
+    enum { NumStages = stagesForRatio(R) };
+    static_assert(R > 1 && (1u << NumStages) == R, "The ratio must be a power of 2");
+
+    typedef typename Design::FirstStage FirstStage;
+    typedef typename Design::NextStage NextStage;
+
+    FirstStage fFirstUp;
+    FirstStage fFirstDown;
+    enum { NumNextStages = (NumStages > 1) ? (NumStages - 1) : 1 };
+    NextStage fNextUp[NumNextStages];
+    NextStage fNextDown[NumNextStages];
+
+    enum { DownsampleChunk = 64 };
+
+    unsigned fLatency = 0;
+    unsigned fPadding = 0;
+    float fPadHistory[R] = {};
+};
+
+//------------------------------------------------------------------------------
+template <class Design, unsigned R>
+HalfbandCascade<Design, R>::HalfbandCascade()
+{
+    Design::initFirstStage(fFirstUp);
+    Design::initFirstStage(fFirstDown);
+    for (unsigned s = 0; s < NumNextStages; ++s) {
+        Design::initNextStage(fNextUp[s], s);
+        Design::initNextStage(fNextDown[s], s);
+    }
+
+    // the stage of index s runs at 2^(s+1) times the base rate
+    double delay = R / 2 * (fFirstUp.getUpsampleLatency() + fFirstDown.getDownsampleLatency());
+    for (unsigned s = 0; s < NumStages - 1; ++s) {
+        unsigned factor = R >> (s + 2);
+        delay += factor * (fNextUp[s].getUpsampleLatency() + fNextDown[s].getDownsampleLatency());
+    }
+
+    unsigned total = (unsigned)std::lround(delay);
+    fLatency = (total + R - 1) / R;
+    fPadding = fLatency * R - total;
+}
+
+template <class Design, unsigned R>
+void HalfbandCascade<Design, R>::reset()
+{
+    fFirstUp.reset();
+    fFirstDown.reset();
+    for (unsigned s = 0; s < NumNextStages; ++s) {
+        fNextUp[s].reset();
+        fNextDown[s].reset();
+    }
+    for (unsigned i = 0; i < R; ++i)
+        fPadHistory[i] = 0;
+}
+
+template <class Design, unsigned R>
+void HalfbandCascade<Design, R>::upsampleBlock(const float *in, float *out, unsigned n)
+{
+    // every stage reads from the upper end of the output and writes from
+    // the start, the write position never passes the read position
+    unsigned len = n;
+    float *src = out + R * n - 2 * len;
+    fFirstUp.upsample(in, (NumStages > 1) ? src : out, len);
+    for (unsigned s = 0; s < NumStages - 1; ++s) {
+        len *= 2;
+        float *dst = (s + 2 < NumStages) ? (out + R * n - 2 * len) : out;
+        fNextUp[s].upsample(src, dst, len);
+        src = dst;
+    }
+
+    // delay the output by the padding, which is less than R
+    unsigned pad = fPadding;
+    if (pad > 0 && n > 0) {
+        float tail[R];
+        std::memcpy(tail, out + R * n - pad, pad * sizeof(float));
+        std::memmove(out + pad, out, (R * n - pad) * sizeof(float));
+        std::memcpy(out, fPadHistory, pad * sizeof(float));
+        std::memcpy(fPadHistory, tail, pad * sizeof(float));
+    }
+}
+
+template <class Design, unsigned R>
+void HalfbandCascade<Design, R>::downsampleBlock(const float *in, float *out, unsigned n)
+{
+    float temp[DownsampleChunk * R / 2];
+
+    while (n > 0) {
+        unsigned current = (n < DownsampleChunk) ? n : (unsigned)DownsampleChunk;
+        unsigned len = current * R / 2;
+        const float *src = in;
+        for (unsigned s = NumStages - 1; s > 0; --s, len /= 2) {
+            fNextDown[s - 1].downsample(src, temp, len);
+            src = temp;
+        }
+        fFirstDown.downsample(src, out, current);
+        in += current * R;
+        out += current;
+        n -= current;
+    }
+}
@@ -0,0 +1,77 @@
+#include "IIROversampler.h"
+#include <cmath>
+
+static double ipow(double x, unsigned n)
+{
+    double z = 1;
+    for (; n != 0; n >>= 1, x *= x) {
+        if (n & 1)
+            z *= x;
+    }
+    return z;
+}
+
+static double computeAccNum(double q, unsigned order, unsigned c)
+{
+    double acc = 0;
+    double term;
+    int sign = 1;
+    unsigned i = 0;
+    do {
+        term = ipow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * M_PI / order) * sign;
+        acc += term;
+        sign = -sign;
+        ++i;
+    } while (std::fabs(term) > 1e-100);
+    return acc;
+}
+
+static double computeAccDen(double q, unsigned order, unsigned c)
+{
+    double acc = 0;
+    double term;
+    int sign = -1;
+    unsigned i = 1;
+    do {
+        term = ipow(q, i * i) * std::cos(i * 2 * c * M_PI / order) * sign;
+        acc += term;
+        sign = -sign;
+        ++i;
+    } while (std::fabs(term) > 1e-100);
+    return acc;
+}
+
+void designHalfbandIIR(double coefs[], unsigned numCoefs, double transition)
+{
+    // transition: width of the transition band, relative to the sample rate
+    double k = std::tan((1 - transition * 2) * M_PI / 4);
+    k *= k;
+    double kksqrt = std::pow(1 - k * k, 0.25);
+    double e = 0.5 * (1 - kksqrt) / (1 + kksqrt);
+    double e2 = e * e;
+    double e4 = e2 * e2;
+    double q = e * (1 + e4 * (2 + e4 * (15 + 150 * e4)));
+
+    unsigned order = numCoefs * 2 + 1;
+    for (unsigned index = 0; index < numCoefs; ++index) {
+        unsigned c = index + 1;
+        double num = computeAccNum(q, order, c) * std::pow(q, 0.25);
+        double den = computeAccDen(q, order, c) + 0.5;
+        double ww = num / den;
+        double wwsq = ww * ww;
+        double x = std::sqrt((1 - wwsq * k) * (1 - wwsq / k)) / (1 + wwsq);
+        coefs[index] = (1 - x) / (1 + x);
+    }
+}
+
+double groupDelayHalfbandIIR(const double coefs[], unsigned numCoefs)
+{
+    // a section (c + z^-2) / (1 + c z^-2) delays DC by 2 (1 - c) / (1 + c),
+    // at DC the two paths are in phase and the sum delays by their mean
+    double delay[2] = {0, 1};
+    for (unsigned index = 0; index < numCoefs; ++index) {
+        double c = coefs[index];
+        delay[index & 1] += 2 * (1 - c) / (1 + c);
+    }
+    return 0.5 * (delay[0] + delay[1]);
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include "HalfbandCascade.h"
+
+// Polyphase IIR half-band filter, made of two chains of allpass sections.
+// H(z) = (A0(z^2) + z^-1 A1(z^2)) / 2
+// The design follows "hiir" by Laurent de Soras.
+// The coefficients are designed once per process, and shared by all instances.
+void designHalfbandIIR(double coefs[], unsigned numCoefs, double transition);
+double groupDelayHalfbandIIR(const double coefs[], unsigned numCoefs);
+
+template <unsigned NC>
+class HalfbandIIR {
+public:
+    static_assert(NC > 0 && NC % 2 == 0, "The number of coefficients must be even");
+
+    struct Kernel {
+        explicit Kernel(double transition);
+        float coefs[NC];
+        double groupDelay;
+    };
+
+    void init(const Kernel &kernel);
+    void reset();
+
+    // n samples in, 2 * n samples out
+    void upsample(const float *in, float *out, unsigned n);
+    // 2 * n samples in, n samples out
+    void downsample(const float *in, float *out, unsigned n);
+
+    // group delay at DC, in samples of the higher rate
+    double getUpsampleLatency() const { return fKernel->groupDelay; }
+    double getDownsampleLatency() const { return fKernel->groupDelay - 1; }
+
+private:
+    // the even and odd sections are the paths A0 and A1,
+    // which are independent and run side by side
+    const Kernel *fKernel = nullptr;
+    float fX[NC] = {};
+    float fY[NC] = {};
+};
+
+template <int Quality> struct IIRHalfbandDesign;
+
+template <> struct IIRHalfbandDesign<HalfbandEconomy> {
+    typedef HalfbandIIR<4> FirstStage;
+    typedef HalfbandIIR<2> NextStage;
+    static void initFirstStage(FirstStage &stage) { static const FirstStage::Kernel kernel(0.1); stage.init(kernel); }
+    static void initNextStage(NextStage &stage, unsigned) { static const NextStage::Kernel kernel(0.3); stage.init(kernel); }
+};
+
+template <> struct IIRHalfbandDesign<HalfbandStandard> {
+    typedef HalfbandIIR<8> FirstStage;
+    typedef HalfbandIIR<4> NextStage;
+    static void initFirstStage(FirstStage &stage) { static const FirstStage::Kernel kernel(0.04); stage.init(kernel); }
+    static void initNextStage(NextStage &stage, unsigned) { static const NextStage::Kernel kernel(0.27); stage.init(kernel); }
+};
+
+template <> struct IIRHalfbandDesign<HalfbandHigh> {
+    typedef HalfbandIIR<12> FirstStage;
+    typedef HalfbandIIR<6> NextStage;
+    static void initFirstStage(FirstStage &stage) { static const FirstStage::Kernel kernel(0.02); stage.init(kernel); }
+    static void initNextStage(NextStage &stage, unsigned) { static const NextStage::Kernel kernel(0.2); stage.init(kernel); }
+};
+
+// Cascade of IIR half-band stages. It has a short,
+// minimum-phase delay, in contrast to the linear-phase FIR oversampler.
+template <unsigned R, int Quality = HalfbandStandard>
+class IIROversampler : public HalfbandCascade<IIRHalfbandDesign<Quality>, R> {
+};
+
+//------------------------------------------------------------------------------
+template <unsigned NC>
+HalfbandIIR<NC>::Kernel::Kernel(double transition)
+{
+    double design[NC];
+    designHalfbandIIR(design, NC, transition);
+    for (unsigned k = 0; k < NC; ++k)
+        coefs[k] = design[k];
+    groupDelay = groupDelayHalfbandIIR(design, NC);
+}
+
+template <unsigned NC>
+void HalfbandIIR<NC>::init(const Kernel &kernel)
+{
+    fKernel = &kernel;
+    reset();
+}
+
+template <unsigned NC>
+void HalfbandIIR<NC>::reset()
+{
+    for (unsigned k = 0; k < NC; ++k) {
+        fX[k] = 0;
+        fY[k] = 0;
+    }
+}
+
+template <unsigned NC>
+void HalfbandIIR<NC>::upsample(const float *in, float *out, unsigned n)
+{
+    float c[NC], x[NC], y[NC];
+    for (unsigned k = 0; k < NC; ++k) {
+        c[k] = fKernel->coefs[k];
+        x[k] = fX[k];
+        y[k] = fY[k];
+    }
+
+    for (unsigned i = 0; i < n; ++i) {
+        float a[2] = {in[i], in[i]};
+        for (unsigned k = 0; k < NC; k += 2) {
+            for (unsigned p = 0; p < 2; ++p) {
+                float t = x[k + p];
+                x[k + p] = a[p];
+                a[p] = (a[p] - y[k + p]) * c[k + p] + t;
+                y[k + p] = a[p];
+            }
+        }
+        out[2 * i] = a[0];
+        out[2 * i + 1] = a[1];
+    }
+
+    for (unsigned k = 0; k < NC; ++k) {
+        fX[k] = x[k];
+        fY[k] = y[k];
+    }
+}
+
+template <unsigned NC>
+void HalfbandIIR<NC>::downsample(const float *in, float *out, unsigned n)
+{
+    float c[NC], x[NC], y[NC];
+    for (unsigned k = 0; k < NC; ++k) {
+        c[k] = fKernel->coefs[k];
+        x[k] = fX[k];
+        y[k] = fY[k];
+    }
+
+    for (unsigned i = 0; i < n; ++i) {
+        // the output is aligned on the second input, so the path A1 does
+        // not need an extra delay
+        float a[2] = {in[2 * i + 1], in[2 * i]};
+        for (unsigned k = 0; k < NC; k += 2) {
+            for (unsigned p = 0; p < 2; ++p) {
+                float t = x[k + p];
+                x[k + p] = a[p];
+                a[p] = (a[p] - y[k + p]) * c[k + p] + t;
+                y[k + p] = a[p];
+            }
+        }
+        out[i] = 0.5f * (a[0] + a[1]);
+    }
+
+    for (unsigned k = 0; k < NC; ++k) {
+        fX[k] = x[k];
+        fY[k] = y[k];
+    }
+}
@@ -9,6 +9,7 @@
 */
 
 #include "VAStateVariableFilter.h"
+#include "dsp/FastTan.h"
 #include <cmath>
 
 #if __cplusplus >= 201703L
@@ -77,6 +78,16 @@ void VAStateVariableFilter::setQ(double newQ)
     calcFilter();
 }
 
+void VAStateVariableFilter::setCutoffFreqAndQ(double newCutoffFreq, double newQ)
+{
+    if (cutoffFreq == newCutoffFreq && Q == newQ)
+        return;
+
+    cutoffFreq = newCutoffFreq;
+    Q = newQ;
+    calcFilter();
+}
+
 void VAStateVariableFilter::setShelfGain(double newGain)
 {
     if (shelfGain == newGain)
@@ -114,12 +125,11 @@ void VAStateVariableFilter::setSampleRate(double newSampleRate)
 void VAStateVariableFilter::calcFilter()
 {
     // prewarp the cutoff (for bilinear-transform filters)
-    double wd = cutoffFreq * (2.0 * M_PI);
-    double T = 1.0 / sampleRate;
-    double wa = (2.0 / T) * std::tan(wd * T / 2.0);
+    // g = wa * T / 2, where wa = (2 / T) * tan(wd * T / 2)
+    double wdT2 = cutoffFreq * M_PI / sampleRate;
 
     // Calculate g (gain element of integrator)
-    gCoeff = wa * T / 2.0;            // Calculate g (gain element of integrator)
+    gCoeff = fastTan(wdT2);
 
     // Calculate Zavalishin's R from Q (referred to as damping parameter)
     RCoeff = 1.0 / (2.0 * Q);
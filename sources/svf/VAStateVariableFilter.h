@@ -90,6 +90,10 @@ public:
     */
     void setQ(double newQ);
 
+    //------------------------------------------------------------------------------
+    /** Sets the cutoff and the Q together, computing the coefficients once. */
+    void setCutoffFreqAndQ(double newCutoffFreq, double newQ);
+
     //------------------------------------------------------------------------------
     /**    Sets the gain of the shelf for the BandShelving filter only. */
     void setShelfGain(double newGain);
@@ -132,6 +136,10 @@ public:
 
     double getShelfGain() const { return shelfGain; }
 
+    double getGCoeff() const { return gCoeff; }
+
+    double getRCoeff() const { return RCoeff; }
+
 private:
     //==============================================================================
     //    Calculate the coefficients for the filter based on parameters.
@@ -1,6 +1,6 @@
 CONFIG += link_pkgconfig
 QT += core gui widgets
-INCLUDEPATH += ../../svf
+INCLUDEPATH += ../.. ../../svf
 SOURCES = run-svf.cpp filter_editor.cpp ../../svf/VAStateVariableFilter.cpp
 JEADERS = filter_editor.h
 FORMS = filter_editor.ui
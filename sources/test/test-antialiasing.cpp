@@ -0,0 +1,111 @@
+#include "Rezonateur.h"
+#include <cstdio>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <utility>
+
+// A high sine, loud enough to saturate the filters, without oversampling.
+// The harmonics above Nyquist fold back between those of the sine, and the
+// antialiased character must have them lower than the saturating one.
+
+static const double sampleRate = 48000.0;
+static const unsigned fftSize = 65536;
+static const unsigned warmup = 48000;
+static const double minimumImprovement = 6.0; // dB
+
+static void fft(std::vector<std::complex<double>> &x)
+{
+    const unsigned n = x.size();
+
+    for (unsigned i = 1, j = 0; i < n; ++i) {
+        unsigned bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(x[i], x[j]);
+    }
+
+    for (unsigned len = 2; len <= n; len <<= 1) {
+        std::complex<double> step = std::polar(1.0, -2 * M_PI / len);
+        for (unsigned i = 0; i < n; i += len) {
+            std::complex<double> w = 1.0;
+            for (unsigned j = 0; j < len / 2; ++j) {
+                std::complex<double> a = x[i + j];
+                std::complex<double> b = x[i + j + len / 2] * w;
+                x[i + j] = a + b;
+                x[i + j + len / 2] = a - b;
+                w *= step;
+            }
+        }
+    }
+}
+
+// the power of the aliases relative to the harmonics, in dB, the sine being
+// on an exact bin of the analysis
+static double measureAliasing(int character, unsigned bin, float level)
+{
+    Rezonateur rez;
+    rez.init(sampleRate);
+    rez.setFilterCharacter(character);
+    rez.setOversampling(1);
+
+    const float cutoffs[] = {500.0f, 2000.0f, 6000.0f};
+    for (unsigned b = 0; b < 3; ++b)
+        rez.setBand(b, 1.0f, cutoffs[b], 5.0f);
+    rez.updateCoefficients();
+
+    const unsigned count = warmup + fftSize;
+    std::vector<float> input(count);
+    std::vector<float> output(count);
+    for (unsigned i = 0; i < count; ++i)
+        input[i] = level * std::sin(2 * M_PI * bin * i / fftSize);
+    rez.process(input.data(), output.data(), count);
+
+    // Blackman-Harris window
+    std::vector<std::complex<double>> spectrum(fftSize);
+    for (unsigned i = 0; i < fftSize; ++i) {
+        double t = 2 * M_PI * i / fftSize;
+        double w = 0.35875 - 0.48829 * std::cos(t) + 0.14128 * std::cos(2 * t) - 0.01168 * std::cos(3 * t);
+        spectrum[i] = w * output[warmup + i];
+    }
+    fft(spectrum);
+
+    // the harmonics span a few bins from the window, the rest is aliasing
+    const int spread = 6;
+    double harmonics = 0;
+    double aliases = 0;
+    for (unsigned k = 8; k < fftSize / 2; ++k) {
+        double power = std::norm(spectrum[k]);
+        unsigned nth = (k + bin / 2) / bin;
+        int distance = (int)k - (int)(nth * bin);
+        if (nth >= 1 && distance >= -spread && distance <= spread)
+            harmonics += power;
+        else
+            aliases += power;
+    }
+
+    return 10 * std::log10(aliases / harmonics);
+}
+
+int main()
+{
+    const unsigned bins[] = {5461, 8011}; // 4 kHz, 5.9 kHz
+    const float levels[] = {0.5f, 2.0f};
+
+    bool ok = true;
+    for (unsigned bin : bins) {
+        for (float level : levels) {
+            double saturating = measureAliasing(Rezonateur::SaturatingCharacter, bin, level);
+            double antialiased = measureAliasing(Rezonateur::AntialiasedCharacter, bin, level);
+            bool lower = antialiased <= saturating - minimumImprovement;
+            printf("[%s] %.0f Hz at %g: aliasing %.1f dB saturating, %.1f dB antialiased\n",
+                   lower ? "ok" : "FAIL", bin * sampleRate / fftSize, level,
+                   saturating, antialiased);
+            ok = ok && lower;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+#include "Rezonateur.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+// The same automated input, rendered with different block sizes, must give
+// the same output to the bit. The parameters change at fixed frames, where
+// the blocks are split, as a host does with sample-accurate automation.
+// The input has silences long enough for the processing to go idle, and
+// some changes fall within them, and shortly before the sound comes back.
+
+static const double sampleRate = 44100.0;
+static const unsigned numFrames = 160000;
+static const unsigned numChannels = 2;
+
+static const unsigned referenceBlockSize = 64;
+
+struct Change {
+    unsigned frame;
+    unsigned band;
+    float cutoff;
+    float gain;
+};
+
+static const Change changes[] = {
+    {1000, 0, 500.0f, 0.8f},
+    {5003, 1, 2500.0f, 0.3f},
+    {9000, 2, 6000.0f, 1.2f},
+    {31017, 0, 200.0f, 1.0f},
+    {39990, 1, 1200.0f, 0.6f},
+    {60007, 2, 4000.0f, 0.5f},
+    {75000, 0, 900.0f, 0.7f},
+    {79990, 1, 3000.0f, 1.1f},
+    {104321, 0, 800.0f, 0.9f},
+    {139995, 2, 7000.0f, 0.4f},
+};
+
+static std::vector<float> makeInput()
+{
+    std::vector<float> input(numFrames);
+    srand(1);
+    for (unsigned i = 0; i < numFrames; ++i) {
+        static const double levels[] = {0.3, 0.001, 1.0, 0.0, 0.002, 0.5, 0.0, 0.3};
+        double level = levels[(i / 20000) % 8];
+        input[i] = level * ((rand() / (double)RAND_MAX) * 2 - 1);
+    }
+    return input;
+}
+
+static std::vector<float> render(unsigned ratio, int type, unsigned blockSize, const std::vector<float> &input)
+{
+    Rezonateur rez;
+    rez.init(sampleRate, numChannels);
+    rez.setMaximumBlockSize(blockSize);
+    rez.setOversamplerType(type);
+    rez.setOversampling(ratio);
+    rez.updateCoefficients();
+
+    std::vector<float> output(numChannels * numFrames);
+    const unsigned numChanges = sizeof(changes) / sizeof(changes[0]);
+    unsigned nextChange = 0;
+
+    for (unsigned i = 0; i < numFrames;) {
+        while (nextChange < numChanges && changes[nextChange].frame == i) {
+            const Change &change = changes[nextChange++];
+            rez.setFilterCutoff(change.band, change.cutoff);
+            rez.setFilterGain(change.band, change.gain);
+        }
+
+        unsigned end = i + blockSize;
+        end = (end < numFrames) ? end : numFrames;
+        if (nextChange < numChanges && changes[nextChange].frame < end)
+            end = changes[nextChange].frame;
+
+        const float *inputs[numChannels];
+        float *outputs[numChannels];
+        for (unsigned c = 0; c < numChannels; ++c) {
+            inputs[c] = &input[i];
+            outputs[c] = &output[c * numFrames + i];
+        }
+        rez.process(inputs, outputs, end - i, inputs, 0.5f, 0.7f);
+        i = end;
+    }
+
+    return output;
+}
+
+int main()
+{
+    const std::vector<float> input = makeInput();
+
+    struct Setting {
+        unsigned ratio;
+        int type;
+        const char *name;
+    };
+    const Setting settings[] = {
+        {1, Rezonateur::FIROversamplerType, "1x"},
+        {4, Rezonateur::FIROversamplerType, "FIR 4x"},
+        {32, Rezonateur::IIROversamplerType, "IIR 32x"},
+        {Rezonateur::AutoOversampling, Rezonateur::FIROversamplerType, "FIR auto"},
+    };
+    const unsigned blockSizes[] = {1, 7, 100, 4096};
+
+    bool success = true;
+
+    for (const Setting &setting : settings) {
+        std::vector<float> reference = render(setting.ratio, setting.type, referenceBlockSize, input);
+
+        for (unsigned blockSize : blockSizes) {
+            std::vector<float> output = render(setting.ratio, setting.type, blockSize, input);
+
+            unsigned differences = 0;
+            double maximumDifference = 0;
+            for (unsigned i = 0; i < output.size(); ++i) {
+                double d = std::fabs((double)output[i] - reference[i]);
+                differences += output[i] != reference[i];
+                maximumDifference = std::fmax(maximumDifference, d);
+            }
+
+            bool ok = differences == 0;
+            success = success && ok;
+            printf("[%s] %s, block %u vs %u: %u samples differ, by %g at most\n",
+                   ok ? "ok" : "FAIL", setting.name, blockSize, referenceBlockSize,
+                   differences, maximumDifference);
+        }
+    }
+
+    return success ? 0 : 1;
+}
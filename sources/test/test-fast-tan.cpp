@@ -0,0 +1,69 @@
+#include "dsp/FastTan.h"
+#include <cstdio>
+#include <cmath>
+
+// The tangent of the prewarping, against std::tan, within the error bound
+// documented in FastTan.h, and over the arguments of the cutoff range.
+
+static double relativeError(double x)
+{
+    double ref = std::tan(x);
+    return std::fabs(fastTan(x) - ref) / ref;
+}
+
+static bool checkInterval(double from, double to, double bound)
+{
+    const unsigned steps = 100000;
+    double worst = 0;
+    double worstX = from;
+
+    for (unsigned i = 0; i <= steps; ++i) {
+        double x = from + (to - from) * i / steps;
+        if (x <= 0)
+            continue;
+        double error = relativeError(x);
+        if (error > worst) {
+            worst = error;
+            worstX = x;
+        }
+    }
+
+    bool ok = worst <= bound;
+    printf("[%s] x in [%g, %g]: error %g at %g, bound %g\n",
+           ok ? "ok" : "FAIL", from, to, worst, worstX, bound);
+    return ok;
+}
+
+static bool checkCutoffRange(double bound)
+{
+    // the cutoffs of the bands, over the sample rates and the ratios
+    const double minCutoff = 60.0;
+    const double maxCutoff = 7500.0;
+    const double samplerates[] = {22050.0, 44100.0, 48000.0, 96000.0, 192000.0};
+    const unsigned steps = 10000;
+    double worst = 0;
+
+    for (double samplerate : samplerates) {
+        for (unsigned ratio = 1; ratio <= 32; ratio *= 2) {
+            for (unsigned i = 0; i <= steps; ++i) {
+                double cutoff = minCutoff * std::pow(maxCutoff / minCutoff, (double)i / steps);
+                double x = cutoff * M_PI / (samplerate * ratio);
+                double error = relativeError(x);
+                worst = (error > worst) ? error : worst;
+            }
+        }
+    }
+
+    bool ok = worst <= bound;
+    printf("[%s] cutoff range: error %g, bound %g\n", ok ? "ok" : "FAIL", worst, bound);
+    return ok;
+}
+
+int main()
+{
+    bool ok = true;
+    ok = checkInterval(0.0, M_PI / 4, 2e-13) && ok;
+    ok = checkInterval(M_PI / 4, 0.49 * M_PI, 1e-12) && ok;
+    ok = checkCutoffRange(1e-12) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include "Rezonateur.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+// The oversampling settings changed after the processing has started, from
+// each one to each other. The low band alone is heard, at 300 Hz and with
+// a high emphasis. After the change, the response to an impulse must ring
+// at the frequency of the band, which holds only if the coefficients follow
+// the rate at which the band runs.
+
+static const double sampleRate = 44100.0;
+static const double cutoff = 300.0;
+static const double maximumFrequencyError = 0.03;
+
+static const unsigned blockSize = 256;
+
+struct Setting {
+    unsigned ratio;
+    int type;
+    const char *name;
+};
+
+static void processFrames(Rezonateur &rez, const float *input, float *output, unsigned count)
+{
+    for (unsigned i = 0; i < count; i += blockSize) {
+        unsigned current = (count - i < blockSize) ? (count - i) : blockSize;
+        rez.process(input + i, output + i, current);
+    }
+}
+
+// the frequency of the ringing, from its upward zero crossings
+static double getRingingFrequency(const float *x, unsigned count)
+{
+    double first = -1, last = -1;
+    unsigned crossings = 0;
+    for (unsigned i = 1; i < count; ++i) {
+        if (x[i - 1] < 0 && x[i] >= 0) {
+            double t = (i - 1) + x[i - 1] / (x[i - 1] - x[i]);
+            first = (crossings == 0) ? t : first;
+            last = t;
+            ++crossings;
+        }
+    }
+    return (crossings > 1) ? ((crossings - 1) * sampleRate / (last - first)) : 0;
+}
+
+static double measure(const Setting &from, const Setting &to)
+{
+    Rezonateur rez;
+    rez.init(sampleRate);
+    rez.setBand(0, 1.0f, cutoff, 10.0f);
+    rez.setBand(1, 0.0f, 1800.0f, 10.0f);
+    rez.setBand(2, 0.0f, 7600.0f, 10.0f);
+    rez.setOversamplerType(from.type);
+    rez.setOversampling(from.ratio);
+    rez.updateCoefficients();
+
+    const unsigned length = 20000;
+    std::vector<float> input(length), output(length);
+
+    srand(1);
+    for (unsigned i = 0; i < length; ++i)
+        input[i] = 0.3 * ((rand() / (double)RAND_MAX) * 2 - 1);
+    processFrames(rez, input.data(), output.data(), length);
+
+    rez.setOversamplerType(to.type);
+    rez.setOversampling(to.ratio);
+
+    for (unsigned i = 0; i < length; ++i)
+        input[i] = 0;
+    input[100] = 0.1f;
+    processFrames(rez, input.data(), output.data(), length);
+
+    // a window of the ringing, past the latency
+    const unsigned start = 100 + rez.getLatency() + 200;
+    return getRingingFrequency(&output[start], 2800);
+}
+
+int main()
+{
+    const Setting settings[] = {
+        {1, Rezonateur::FIROversamplerType, "1x"},
+        {4, Rezonateur::FIROversamplerType, "FIR 4x"},
+        {32, Rezonateur::FIROversamplerType, "FIR 32x"},
+        {8, Rezonateur::IIROversamplerType, "IIR 8x"},
+        {Rezonateur::AutoOversampling, Rezonateur::FIROversamplerType, "FIR auto"},
+        {Rezonateur::AutoOversampling, Rezonateur::IIROversamplerType, "IIR auto"},
+    };
+
+    bool success = true;
+
+    for (const Setting &from : settings) {
+        for (const Setting &to : settings) {
+            if (&from == &to)
+                continue;
+
+            double frequency = measure(from, to);
+            bool ok = std::fabs(frequency / cutoff - 1) <= maximumFrequencyError;
+            success = success && ok;
+            printf("[%s] %s to %s: rings at %g Hz\n", ok ? "ok" : "FAIL", from.name, to.name, frequency);
+        }
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+#include "Rezonateur.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+// The filters in single precision, at the extremes of the parameters: the
+// highest cutoffs and emphasis, at the highest oversampling ratio where the
+// coefficients are the smallest, and without oversampling where the poles
+// are the closest to Nyquist, and the lowest cutoff of the low band, where
+// g is the smallest which the plugin sets.
+// On a noise, the output must stay bounded. Its error is not measured, the
+// implicit model at this emphasis is chaotic, in double precision already.
+// On a sweep across the resonances, the output must be close to the one in
+// double precision.
+
+static const double sampleRate = 44100.0;
+static const unsigned numFrames = 44100;
+
+static const double maximumError = 1e-4; // -80 dB, relative RMS
+static const double maximumPeakRatio = 2.0;
+
+struct Case {
+    float cutoffs[3];
+    unsigned ratio;
+};
+
+static std::vector<float> render(int precision, int character, const Case &setting, const std::vector<float> &input)
+{
+    Rezonateur rez;
+    rez.init(sampleRate);
+    rez.setFilterPrecision(precision);
+    rez.setFilterCharacter(character);
+    rez.setOversampling(setting.ratio);
+
+    for (unsigned b = 0; b < 3; ++b)
+        rez.setBand(b, 1.0f, setting.cutoffs[b], 10.0f);
+    rez.updateCoefficients();
+
+    std::vector<float> output(input.size());
+    rez.process(input.data(), output.data(), input.size());
+    return output;
+}
+
+static double getPeak(const std::vector<float> &x)
+{
+    double peak = 0;
+    for (float s : x)
+        peak = std::isfinite(s) ? std::fmax(peak, std::fabs(s)) : INFINITY;
+    return peak;
+}
+
+static double getRelativeError(const std::vector<float> &x, const std::vector<float> &reference)
+{
+    double error = 0, energy = 0;
+    for (unsigned i = 0; i < x.size(); ++i) {
+        double d = (double)x[i] - reference[i];
+        error += d * d;
+        energy += (double)reference[i] * reference[i];
+    }
+    return std::sqrt(error / energy);
+}
+
+int main()
+{
+    std::vector<float> noise(numFrames);
+    srand(1);
+    for (unsigned i = 0; i < numFrames; ++i)
+        noise[i] = 0.5 * ((rand() / (double)RAND_MAX) * 2 - 1);
+
+    std::vector<float> sweep(numFrames);
+    double phase = 0;
+    for (unsigned i = 0; i < numFrames; ++i) {
+        double t = (double)i / numFrames;
+        phase += 2 * M_PI * (50.0 * std::pow(200.0, t)) / sampleRate;
+        sweep[i] = 0.5 * std::sin(phase);
+    }
+
+    const int characters[] = {
+        Rezonateur::LinearCharacter,
+        Rezonateur::SaturatingCharacter,
+        Rezonateur::ImplicitCharacter,
+        Rezonateur::AntialiasedCharacter,
+    };
+    const char *characterNames[] = {"linear", "saturating", "implicit", "antialiased"};
+    const Case cases[] = {
+        {{300.0f, 1500.0f, 7500.0f}, 1},
+        {{300.0f, 1500.0f, 7500.0f}, 32},
+        {{60.0f, 1500.0f, 7500.0f}, 8},
+    };
+
+    bool ok = true;
+    for (unsigned c = 0; c < 4; ++c) {
+        for (const Case &setting : cases) {
+            double peak = getPeak(render(Rezonateur::SinglePrecision, characters[c], setting, noise));
+            double referencePeak = getPeak(render(Rezonateur::DoublePrecision, characters[c], setting, noise));
+            bool bounded = peak <= maximumPeakRatio * referencePeak;
+
+            double error = getRelativeError(
+                render(Rezonateur::SinglePrecision, characters[c], setting, sweep),
+                render(Rezonateur::DoublePrecision, characters[c], setting, sweep));
+            bool close = error <= maximumError;
+
+            printf("[%s] %s %ux, low band at %g Hz: noise peak %g (double %g), sweep error %g\n",
+                   (bounded && close) ? "ok" : "FAIL", characterNames[c], setting.ratio,
+                   setting.cutoffs[0], peak, referencePeak, error);
+            ok = ok && bounded && close;
+        }
+    }
+
+    return ok ? 0 : 1;
+}